@@ -0,0 +1,204 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 04/06/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: Banked_datapath - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Selection sort datapath that examines LANES elements per clock, an
+-- alternative to Sorting_datapath with the same host-side ports (selected by
+-- SEL_LANES in chu_sorting_core) and the same controller (S1..S3).
+--
+-- The 2^13-word memory is split into LANES interleaved banks (RAM instances):
+-- element e lives in bank e mod LANES, row e / LANES, as in Network_datapath.
+--  * S1: port A reads the row of M[i], port B the row of M[i+1]
+--  * S2: port B streams one row per clock; a comparator reduction tree picks
+--        the smallest element of the row with index i < e < N (lower lane on
+--        ties), which is compared with the running minimum (MigtMj)
+--  * S3: the minimum is written to M[i] (port A) and M[i] to its old place
+--        (port B), once per outer iteration
+-- Latency: sum over i = 0..N-2 of (3 + (N-1)/LANES - (i+1)/LANES) clocks,
+-- ~N^2 / (2 LANES); i = 0..K-1 with a partial sort (K_in).
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity Banked_datapath is
+    Generic(LANES : integer := 4; --banks / candidates per clock (power of 2, 1..16)
+            DATA_WIDTH : integer := 16); --element word (key and index)
+    Port (clk, Rd, WrInit : in std_logic;
+          s : in std_logic;
+          DataIn : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          RAdd : in std_logic_vector(12 downto 0);
+          --second host port (port B while s = '0', see pack_unit)
+          WrInitB : in std_logic;
+          DataInB : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          RAddB : in std_logic_vector(12 downto 0);
+          N_in : in std_logic_vector(15 downto 0);
+          K_in : in std_logic_vector(15 downto 0); --partial sort: first K elements, 0: all
+          --control signals from the controller
+          Wr, Li, Ei, Lj, Ej, Emin : in std_logic;
+          --control signals for wrapper circuit
+          Done, addr_ctrl : in std_logic;
+          --control signals to the controller
+          MigtMj, zi, zj : out std_logic; --zj: last row
+          zn : out std_logic; --N = 1, no selection sort pass
+          --datapath output
+          DataOut : out std_logic_vector(15 downto 0);
+          HostA, HostB : out std_logic_vector(DATA_WIDTH-1 downto 0)); --bank outputs for the host ports
+end Banked_datapath;
+
+architecture Behavioral of Banked_datapath is
+    constant LG_LANES : integer := log2c(LANES);
+    constant ROW_W : integer := MEM_ADDR_WIDTH - LG_LANES;
+    type lane_array is array (0 to LANES-1) of std_logic_vector(DATA_WIDTH-1 downto 0);
+    --reduction tree: node 1 is the root, nodes LANES .. 2 LANES-1 the lanes
+    type node_array is array (1 to 2*LANES-1) of std_logic_vector(DATA_WIDTH-1 downto 0);
+    type nidx_array is array (1 to 2*LANES-1) of unsigned(12 downto 0);
+    signal douta, doutb, dina, dinb : lane_array; --bank ports
+    signal wea, web : std_logic_vector(LANES-1 downto 0);
+    signal tv : node_array;
+    signal tx : nidx_array;
+    signal tok, tgt : std_logic_vector(1 to 2*LANES-1);
+    signal icount : std_logic_vector(12 downto 0);
+    signal rc, rd : unsigned(ROW_W-1 downto 0); --row counter, row in doutb
+    signal row_i, row_i1, row_last : unsigned(ROW_W-1 downto 0);
+    signal AddrA, AddrB, host_row, host_rowB : std_logic_vector(ROW_W-1 downto 0);
+    signal host_lane, host_lane_r, host_laneB, host_laneB_r : integer range 0 to LANES-1;
+    signal lane_i, lane_min : integer range 0 to LANES-1;
+    signal n_eff : unsigned(13 downto 0);
+    signal Mi, minv, cur_min : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal minidx : unsigned(12 downto 0);
+    signal found, MigtMj_i, Wsw : std_logic;
+    signal done_mux_out : std_logic_vector(15 downto 0);
+begin
+
+    --interleaved banks
+    bank_gen : for c in 0 to LANES-1 generate
+        bank : entity work.RAM(Behavioral)
+            Generic Map(ADDR_WIDTH => ROW_W,
+                        DATA_WIDTH => DATA_WIDTH)
+            Port Map(clk => clk,
+                     wea => wea(c),
+                     web => web(c),
+                     addra => AddrA,
+                     addrb => AddrB,
+                     dina => dina(c),
+                     dinb => dinb(c),
+                     douta => douta(c),
+                     doutb => doutb(c));
+    end generate;
+
+    I_loop_counter : entity work.icounter(Behavioral)
+        Port Map(clk => clk,
+                 N => N_in(12 downto 0),
+                 K => K_in(12 downto 0),
+                 en => Ei,
+                 ld => Li,
+                 Q => icount,
+                 zi => zi,
+                 zn => zn);
+
+    n_eff <= "10000000000000" when unsigned(N_in(12 downto 0)) = 0 else resize(unsigned(N_in(12 downto 0)), 14);
+    row_i <= resize(shift_right(unsigned(icount), LG_LANES), ROW_W);
+    row_i1 <= resize(shift_right(unsigned(icount) + 1, LG_LANES), ROW_W);
+    row_last <= resize(shift_right(n_eff - 1, LG_LANES), ROW_W);
+    lane_i <= to_integer(unsigned(icount)) mod LANES;
+    lane_min <= to_integer(minidx) mod LANES;
+
+    --row counter (j loop) and running minimum
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            rd <= unsigned(AddrB); --RAM output is one clock behind the address
+            if (Ej = '1') then
+                if (Lj = '1') then
+                    rc <= row_i1 + 1; --port B reads row_i1 during the load
+                else
+                    rc <= rc + 1;
+                end if;
+            end if;
+            if (Li = '1' or Lj = '1') then
+                found <= '0';
+            elsif (Emin = '1') then
+                found <= '1';
+                minv <= tv(1);
+                minidx <= tx(1);
+            end if;
+        end if;
+    end process;
+    zj <= '1' when rd = row_last else '0';
+
+    --candidates: row rd, elements i < e < N
+    leaf_gen : for c in 0 to LANES-1 generate
+        tv(LANES + c) <= doutb(c);
+        tx(LANES + c) <= resize(shift_left(resize(rd, 13), LG_LANES), 13) + c;
+        tok(LANES + c) <= '1' when (tx(LANES + c) > unsigned(icount) and
+                                    resize(tx(LANES + c), 14) < n_eff) else '0';
+    end generate;
+
+    --comparator reduction tree, LANES-1 comparators
+    node_gen : for t in 1 to LANES-1 generate
+        node_cmp : entity work.Comparator(Behavioral)
+            Generic Map(DATA_WIDTH => DATA_WIDTH)
+            Port Map(A => tv(2*t),
+                     B => tv(2*t+1),
+                     AgtB => tgt(t));
+        --the right child wins only if it is valid and strictly smaller
+        tv(t) <= tv(2*t+1) when (tok(2*t+1) = '1' and (tok(2*t) = '0' or tgt(t) = '1')) else tv(2*t);
+        tx(t) <= tx(2*t+1) when (tok(2*t+1) = '1' and (tok(2*t) = '0' or tgt(t) = '1')) else tx(2*t);
+        tok(t) <= tok(2*t) or tok(2*t+1);
+    end generate;
+
+    --row minimum against the running minimum (M[i] until one is found)
+    Mi <= douta(lane_i);
+    cur_min <= minv when (found = '1') else Mi;
+    Min_compare : entity work.Comparator(Behavioral)
+        Generic Map(DATA_WIDTH => DATA_WIDTH)
+        Port Map(A => cur_min,
+                 B => tv(1),
+                 AgtB => MigtMj_i);
+    MigtMj <= MigtMj_i and tok(1);
+
+    --multiplexing for the bank ports (host access when s = '0')
+    host_row <= std_logic_vector(resize(shift_right(unsigned(RAdd), LG_LANES), ROW_W));
+    host_lane <= to_integer(unsigned(RAdd)) mod LANES;
+    host_rowB <= std_logic_vector(resize(shift_right(unsigned(RAddB), LG_LANES), ROW_W));
+    host_laneB <= to_integer(unsigned(RAddB)) mod LANES;
+    AddrA <= std_logic_vector(row_i) when (s = '1') else host_row;
+    AddrB <= host_rowB when (s = '0') else
+             std_logic_vector(resize(shift_right(minidx, LG_LANES), ROW_W)) when (Wr = '1') else
+             std_logic_vector(row_i1) when (Lj = '1') else std_logic_vector(rc);
+    Wsw <= Wr and found;
+    port_gen : for c in 0 to LANES-1 generate
+        dina(c) <= minv when (s = '1') else DataIn;
+        dinb(c) <= Mi when (s = '1') else DataInB;
+        wea(c) <= Wsw when (s = '1' and lane_i = c) else
+                  WrInit when (s = '0' and host_lane = c) else '0';
+        web(c) <= Wsw when (s = '1' and lane_min = c) else
+                  WrInitB when (s = '0' and host_laneB = c) else '0';
+    end generate;
+
+    --banks of the last host reads (RAM output is registered)
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            host_lane_r <= host_lane;
+            host_laneB_r <= host_laneB;
+        end if;
+    end process;
+    HostA <= douta(host_lane_r);
+    HostB <= doutb(host_laneB_r);
+
+    --multiplexing controlled by RdDone
+    done_mux_out <= "000000000000000" & Done when (addr_ctrl = '1') else
+                    std_logic_vector(resize(unsigned(douta(host_lane_r)), 16));
+
+    --multiplexing controlled by Rd
+    DataOut <= done_mux_out when (Rd = '1') else (others => '0');
+
+end Behavioral;
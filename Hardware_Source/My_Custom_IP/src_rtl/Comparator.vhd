@@ -15,8 +15,9 @@ use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
 
 entity Comparator is
-    Port (A : in std_logic_vector(15 downto 0);
-          B : in std_logic_vector(15 downto 0);
+    Generic(DATA_WIDTH : integer := 16);
+    Port (A : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          B : in std_logic_vector(DATA_WIDTH-1 downto 0);
           AgtB : out std_logic);
 end Comparator;
 
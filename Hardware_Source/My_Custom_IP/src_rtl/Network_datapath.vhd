@@ -0,0 +1,227 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/02/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: Network_datapath - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Bitonic sorting network datapath, an alternative to Sorting_datapath with
+-- the same host-side ports (selected by NET_LANES in chu_sorting_core).
+--
+-- The 2^13-word memory is split into LANES interleaved banks (RAM instances):
+-- element e lives in bank e mod LANES, row e / LANES. Every pass reads two
+-- rows (port A: ra, port B: rb) and sends them through LANES compare_exchange
+-- lanes before writing both rows back in place:
+--  * lgj >= log2(LANES): partners are in the same bank, rb = ra + 2^lgj/LANES,
+--    lane c compares A(c) with B(c)
+--  * lgj <  log2(LANES): partners are in the same row (lane c with c xor j),
+--    half of the lanes work on row ra = 2p, the other half on rb = 2p+1
+-- Element i is sorted ascending when bit lgk of i is '0'. During the first
+-- pass, elements N..2^lgN-1 read as all ones so any N sorts correctly.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity Network_datapath is
+    Generic(LANES : integer := 16; --compare-exchange lanes (power of 2, 1..16)
+            DATA_WIDTH : integer := 16); --element word (key and index)
+    Port (clk, Rd, WrInit : in std_logic;
+          s : in std_logic;
+          DataIn : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          RAdd : in std_logic_vector(12 downto 0);
+          --second host port (port B while s = '0', see pack_unit)
+          WrInitB : in std_logic;
+          DataInB : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          RAddB : in std_logic_vector(12 downto 0);
+          N_in : in std_logic_vector(15 downto 0);
+          --control signals from the network controller
+          lgk, lgj : in std_logic_vector(3 downto 0);
+          p : in std_logic_vector(11 downto 0);
+          First, Wb : in std_logic;
+          --control signals for wrapper circuit
+          Done, addr_ctrl : in std_logic;
+          --datapath output
+          DataOut : out std_logic_vector(15 downto 0);
+          HostA, HostB : out std_logic_vector(DATA_WIDTH-1 downto 0)); --bank outputs for the host ports
+end Network_datapath;
+
+architecture Behavioral of Network_datapath is
+    constant LG_LANES : integer := log2c(LANES);
+    constant ROW_W : integer := MEM_ADDR_WIDTH - LG_LANES;
+    constant HALF : integer := (LANES + 1) / 2; --pairs per row when partners share a row
+    type lane_array is array (0 to LANES-1) of std_logic_vector(DATA_WIDTH-1 downto 0);
+    type idx_array is array (0 to LANES-1) of unsigned(13 downto 0);
+    signal douta, doutb, dina, dinb : lane_array; --bank ports
+    signal MA, MB : lane_array; --rows read by the engine (padded)
+    signal NewA, NewB : lane_array; --rows after compare-exchange
+    signal ce_x, ce_y, ce_l, ce_h : lane_array; --compare_exchange lanes
+    signal ce_asc, ascA, ascB : std_logic_vector(LANES-1 downto 0);
+    signal wea, web : std_logic_vector(LANES-1 downto 0);
+    signal idxA, idxB : idx_array; --element index of each lane
+    signal ra, rb : unsigned(ROW_W-1 downto 0); --engine rows
+    signal AddrA, AddrB, host_row, host_rowB : std_logic_vector(ROW_W-1 downto 0);
+    signal host_lane, host_lane_r, host_laneB, host_laneB_r : integer range 0 to LANES-1;
+    signal caseA : std_logic; --partners in different rows
+    signal n_eff, kmask : unsigned(13 downto 0);
+    signal done_mux_out : std_logic_vector(15 downto 0);
+begin
+
+    --interleaved banks
+    bank_gen : for c in 0 to LANES-1 generate
+        bank : entity work.RAM(Behavioral)
+            Generic Map(ADDR_WIDTH => ROW_W,
+                        DATA_WIDTH => DATA_WIDTH)
+            Port Map(clk => clk,
+                     wea => wea(c),
+                     web => web(c),
+                     addra => AddrA,
+                     addrb => AddrB,
+                     dina => dina(c),
+                     dinb => dinb(c),
+                     douta => douta(c),
+                     doutb => doutb(c));
+    end generate;
+
+    --row pair p of the current pass
+    process(p, lgj)
+        variable pv, low_mask, r : unsigned(ROW_W-1 downto 0);
+        variable sh : integer range 0 to 15;
+    begin
+        pv := resize(unsigned(p), ROW_W);
+        if (to_integer(unsigned(lgj)) >= LG_LANES) then
+            --insert a '0' at bit (lgj - log2 LANES) of p
+            sh := to_integer(unsigned(lgj)) - LG_LANES;
+            low_mask := shift_left(to_unsigned(1, ROW_W), sh) - 1;
+            r := shift_left(shift_right(pv, sh), sh + 1) or (pv and low_mask);
+            ra <= r;
+            rb <= r or shift_left(to_unsigned(1, ROW_W), sh);
+            caseA <= '1';
+        else
+            ra <= shift_left(pv, 1);
+            rb <= shift_left(pv, 1) + 1;
+            caseA <= '0';
+        end if;
+    end process;
+
+    --element index, direction and first-pass padding per lane
+    n_eff <= "10000000000000" when unsigned(N_in(12 downto 0)) = 0 else resize(unsigned(N_in(12 downto 0)), 14);
+    kmask <= shift_left(to_unsigned(1, 14), to_integer(unsigned(lgk)));
+    lane_gen : for c in 0 to LANES-1 generate
+        idxA(c) <= shift_left(resize(ra, 14), LG_LANES) + c;
+        idxB(c) <= shift_left(resize(rb, 14), LG_LANES) + c;
+        ascA(c) <= '1' when (idxA(c) and kmask) = 0 else '0';
+        ascB(c) <= '1' when (idxB(c) and kmask) = 0 else '0';
+        MA(c) <= (others => '1') when (First = '1' and idxA(c) >= n_eff) else douta(c);
+        MB(c) <= (others => '1') when (First = '1' and idxB(c) >= n_eff) else doutb(c);
+    end generate;
+
+    --compare_exchange lanes
+    ce_gen : for u in 0 to LANES-1 generate
+        ce_unit : entity work.compare_exchange(Behavioral)
+            Generic Map(DATA_WIDTH => DATA_WIDTH)
+            Port Map(A => ce_x(u),
+                     B => ce_y(u),
+                     asc => ce_asc(u),
+                     L => ce_l(u),
+                     H => ce_h(u));
+    end generate;
+
+    --lane input multiplexing
+    --caseA: lane u takes A(u)/B(u); otherwise lane u < LANES/2 takes the
+    --u-th pair of row A and lane LANES/2+u the u-th pair of row B
+    process(caseA, lgj, MA, MB, ascA, ascB)
+        variable sh : integer range 0 to 15;
+        variable c, cp : integer range 0 to LANES-1;
+        variable uv, jv : unsigned(LG_LANES downto 0);
+    begin
+        for u in 0 to LANES-1 loop
+            if (caseA = '1') then
+                ce_x(u) <= MA(u);
+                ce_y(u) <= MB(u);
+                ce_asc(u) <= ascA(u);
+            else
+                --lower lane of pair u: insert a '0' at bit lgj of u
+                sh := to_integer(unsigned(lgj));
+                jv := shift_left(to_unsigned(1, LG_LANES + 1), sh);
+                uv := to_unsigned(u mod HALF, LG_LANES + 1);
+                c := to_integer(shift_left(shift_right(uv, sh), sh + 1) or (uv and (jv - 1)));
+                cp := c + to_integer(jv);
+                if (u < HALF) then
+                    ce_x(u) <= MA(c);
+                    ce_y(u) <= MA(cp);
+                    ce_asc(u) <= ascA(c);
+                else
+                    ce_x(u) <= MB(c);
+                    ce_y(u) <= MB(cp);
+                    ce_asc(u) <= ascB(c);
+                end if;
+            end if;
+        end loop;
+    end process;
+
+    --lane output demultiplexing back to element positions
+    process(caseA, lgj, ce_l, ce_h)
+        variable sh : integer range 0 to 15;
+        variable u : integer range 0 to LANES-1;
+        variable cv, jv : unsigned(LG_LANES downto 0);
+    begin
+        for c in 0 to LANES-1 loop
+            if (caseA = '1') then
+                NewA(c) <= ce_l(c);
+                NewB(c) <= ce_h(c);
+            else
+                --pair index of lane c: drop bit lgj of c
+                sh := to_integer(unsigned(lgj));
+                jv := shift_left(to_unsigned(1, LG_LANES + 1), sh);
+                cv := to_unsigned(c, LG_LANES + 1);
+                u := to_integer(shift_left(shift_right(cv, sh + 1), sh) or (cv and (jv - 1)));
+                if ((cv and jv) = 0) then
+                    NewA(c) <= ce_l(u);
+                    NewB(c) <= ce_l(u + HALF);
+                else
+                    NewA(c) <= ce_h(u);
+                    NewB(c) <= ce_h(u + HALF);
+                end if;
+            end if;
+        end loop;
+    end process;
+
+    --multiplexing for the bank ports (host access when s = '0')
+    host_row <= std_logic_vector(resize(shift_right(unsigned(RAdd), LG_LANES), ROW_W));
+    host_lane <= to_integer(unsigned(RAdd)) mod LANES;
+    host_rowB <= std_logic_vector(resize(shift_right(unsigned(RAddB), LG_LANES), ROW_W));
+    host_laneB <= to_integer(unsigned(RAddB)) mod LANES;
+    AddrA <= std_logic_vector(ra) when (s = '1') else host_row;
+    AddrB <= std_logic_vector(rb) when (s = '1') else host_rowB;
+    port_gen : for c in 0 to LANES-1 generate
+        dina(c) <= NewA(c) when (s = '1') else DataIn;
+        dinb(c) <= NewB(c) when (s = '1') else DataInB;
+        wea(c) <= Wb when (s = '1') else
+                  WrInit when (host_lane = c) else '0';
+        web(c) <= Wb when (s = '1') else
+                  WrInitB when (host_laneB = c) else '0';
+    end generate;
+
+    --banks of the last host reads (RAM output is registered)
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            host_lane_r <= host_lane;
+            host_laneB_r <= host_laneB;
+        end if;
+    end process;
+    HostA <= douta(host_lane_r);
+    HostB <= doutb(host_laneB_r);
+
+    --multiplexing controlled by RdDone
+    done_mux_out <= "000000000000000" & Done when (addr_ctrl = '1') else
+                    std_logic_vector(resize(unsigned(douta(host_lane_r)), 16));
+
+    --multiplexing controlled by Rd
+    DataOut <= done_mux_out when (Rd = '1') else (others => '0');
+
+end Behavioral;
@@ -20,21 +20,25 @@ use IEEE.NUMERIC_STD.ALL;
 --use UNISIM.VComponents.all;
 
 entity RAM is  
+    Generic(
+    ADDR_WIDTH : integer := 13; -- 2^13 words
+    DATA_WIDTH : integer := 16
+    );
 	Port(
     clk   : in  std_logic;
     wea   : in  std_logic;
     web   : in  std_logic;
-    addra : in  std_logic_vector(12 downto 0);
-    addrb : in  std_logic_vector(12 downto 0);
-    dina   : in  std_logic_vector(15 downto 0);
-    dinb   : in  std_logic_vector(15 downto 0);
-    douta   : out std_logic_vector(15 downto 0);
-    doutb   : out std_logic_vector(15 downto 0)
+    addra : in  std_logic_vector(ADDR_WIDTH-1 downto 0);
+    addrb : in  std_logic_vector(ADDR_WIDTH-1 downto 0);
+    dina   : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    dinb   : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    douta   : out std_logic_vector(DATA_WIDTH-1 downto 0);
+    doutb   : out std_logic_vector(DATA_WIDTH-1 downto 0)
     );
 end RAM;
 
 architecture Behavioral of RAM is
-    type ram_type is array (0 to 2**13-1) of std_logic_vector(15 downto 0);   
+    type ram_type is array (0 to 2**ADDR_WIDTH-1) of std_logic_vector(DATA_WIDTH-1 downto 0);   
     shared variable RAM : ram_type := (others => (others => '0'));
 begin
     process (clk)   
@@ -9,58 +9,128 @@
 -- Tool Versions: Vivado 2023.x / Vitis 2023.x
 ----------------------------------------------------------------------------------
 
+-- alg = ALG_SELECTION : selection sort on the current bank (icounter/jcounter);
+--                       port B streams M[j] one address ahead of the
+--                       comparison, the running minimum and its index are
+--                       kept in registers (MigtMj: minimum > Mj) and Wr
+--                       swaps it with M[i] once per outer iteration;
+--                       K_in /= 0 stops after K outer iterations (top-K)
+-- alg = ALG_MERGE     : bottom-up merge sort, each pass streams the current
+--                       bank into the other one (merge_counters), one
+--                       element per clock, then swaps the banks
+-- alg = ALG_RADIX     : LSD radix sort, each digit counts port A of the
+--                       current bank and scatters it into the other one
+--                       through port C (radix_counters), then swaps the banks
+-- alg = ALG_SELECT    : radix_counters from the most significant digit,
+--                       keeping only the bucket of rank K_in-1 (selection)
+-- db = '1'            : (HOST_BANK) the host ports use the host bank of
+--                       dual_bank_RAM, so the next data set can be loaded
+--                       (and the last result read) while the engine sorts;
+--                       hswap exchanges the host bank with the current bank
+
 library IEEE;
 use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
 
 entity Sorting_datapath is
+    Generic(DATA_WIDTH : integer := 16; --element word (key and index)
+            KEY_WIDTH : integer := 16;
+            RADIX_BITS : integer := 8; --digit of the radix sort
+            HOST_BANK : boolean := false); --third RAM bank for double buffering
     Port (clk, Rd, WrInit : in std_logic;
           s : in std_logic; 
-          DataIn : in std_logic_vector(15 downto 0);
+          alg : in std_logic_vector(2 downto 0); --algorithm select
+          DataIn : in std_logic_vector(DATA_WIDTH-1 downto 0);
           RAdd : in std_logic_vector(12 downto 0);
+          --second host port (port B while s = '0', see pack_unit)
+          WrInitB : in std_logic;
+          DataInB : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          RAddB : in std_logic_vector(12 downto 0);
+          --double buffering
+          db, hswap : in std_logic;
           --input N for loop counters
           N_in : in std_logic_vector(15 downto 0);
+          K_in : in std_logic_vector(15 downto 0); --partial sort: first K elements, 0: all
           --control signals from the controller
-          Wr, Li, Ei, Lj, Ej : in std_logic;
+          Wr, Li, Ei, Lj, Ej, Emin : in std_logic;
+          Lw, Lp, Em, Enp, Ew : in std_logic; --merge sort
+          Lr, Rc, Rp, Rs, Lc, Enr : in std_logic; --radix sort
           --added control signals for wrapper circuit 
           Done, addr_ctrl : in std_logic; --addr_ctrl signal for douta mux
           --control signals to the controller
-          MigtMj, zi, zj : out std_logic;
+          MigtMj, zi, zj : out std_logic; --zj: Mj is M[N-1]
+          zn : out std_logic; --N = 1, no selection sort pass
+          zk, zlo, zw : out std_logic; --merge sort
+          zc, zb, zp : out std_logic; --radix sort
           --datapath output          
-          DataOut : out std_logic_vector(15 downto 0));
+          DataOut : out std_logic_vector(15 downto 0);
+          HostA, HostB : out std_logic_vector(DATA_WIDTH-1 downto 0)); --RAM outputs for the host ports
 end Sorting_datapath;
 
 architecture Behavioral of Sorting_datapath is
-    signal wea : std_logic;
-    signal AddrA : std_logic_vector(12 downto 0); --address going into address A of RAM
+    signal wea, web : std_logic;
+    signal AddrA, AddrB : std_logic_vector(12 downto 0); --addresses going into the RAM
     signal icounter_out, jcounter_out : std_logic_vector(12 downto 0); --addresses coming from counter i and j
     signal jcounter_in : std_logic_vector(12 downto 0);
-    signal dina : std_logic_vector(15 downto 0);
-    signal Mi, Mj : std_logic_vector(15 downto 0);
+    signal dina, dinb : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal Mi, Mj : std_logic_vector(DATA_WIDTH-1 downto 0);
     signal done_mux_out : std_logic_vector(15 downto 0); -- added signal for mux controlled by RdDone
+    signal merge, radix, rsel : std_logic;
+    signal raddr, rk : std_logic_vector(12 downto 0); --radix element and scatter addresses
+    signal rdata : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal rwe, wec : std_logic;
+    signal addrc : std_logic_vector(12 downto 0);
+    signal MigtMj_i, take : std_logic;
+    signal inext, jnext, kaddr : std_logic_vector(12 downto 0); --merge run pointers
+    signal dinc : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal eng : std_logic; --engine owns the current bank
+    signal hwea, hweb : std_logic;
+    signal hdouta, hdoutb : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal jd, minidx : std_logic_vector(12 downto 0); --address of Mj, index of the minimum
+    signal minv, cur_min : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal found : std_logic; --minimum is not M[i]
     
 begin
 
-    RAM : entity work.RAM(Behavioral)
+    RAM : entity work.dual_bank_RAM(Behavioral)
+        Generic Map(DATA_WIDTH => DATA_WIDTH,
+                    HOST_BANK => HOST_BANK)
         Port Map(clk => clk,
+                 swap => Ew,
+                 hswap => hswap,
                  wea => wea,
-                 web => Wr,
+                 web => web,
                  addra => AddrA,
-                 addrb => jcounter_out,
+                 addrb => AddrB,
                  dina => dina,
-                 dinb => Mi, --dinb always connected to Mi
+                 dinb => dinb,
                  douta => Mi,
-                 doutb => Mj);
+                 doutb => Mj,
+                 wec => wec,
+                 addrc => addrc,
+                 dinc => dinc,
+                 hwea => hwea,
+                 hweb => hweb,
+                 haddra => RAdd,
+                 haddrb => RAddB,
+                 hdina => DataIn,
+                 hdinb => DataInB,
+                 hdouta => hdouta,
+                 hdoutb => hdoutb,
+                 bank => open);
                  
     I_loop_counter : entity work.icounter(Behavioral)
         Port Map(clk => clk,
                  N => N_in(12 downto 0),
+                 K => K_in(12 downto 0),
                  en => Ei,
                  ld => Li,
                  Q => icounter_out,
-                 zi => zi);
+                 zi => zi,
+                 zn => zn);
                  
-    jcounter_in <= std_logic_vector(unsigned(icounter_out) + 1); --input of i counter + 1 into j counter
+    jcounter_in <= std_logic_vector(unsigned(icounter_out) + 2); --i + 2, port B reads i + 1 during the load
     
     J_loop_counter : entity work.jcounter(Behavioral)
         Port Map(clk => clk,
@@ -69,26 +139,112 @@ begin
                  ld => Lj,
                  D => jcounter_in,
                  Q => jcounter_out,
-                 zj => zj);
+                 zj => open);
+
+    --running minimum of the selection sort
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            jd <= AddrB; --RAM output is one clock behind the address
+            if (Li = '1' or Lj = '1') then
+                found <= '0';
+            elsif (Emin = '1') then
+                found <= '1';
+                minv <= Mj;
+                minidx <= jd;
+            end if;
+        end if;
+    end process;
+    zj <= '1' when unsigned(jd) = unsigned(N_in(12 downto 0)) - 1 else '0';
+    cur_min <= minv when (found = '1') else Mi;
 
     Comparator_Block : entity work.Comparator(Behavioral)
-        Port Map(A => Mi,
+        Generic Map(DATA_WIDTH => DATA_WIDTH)
+        Port Map(A => cur_min,
                  B => Mj,
-                 AgtB => MigtMj);
+                 AgtB => MigtMj_i);
+    MigtMj <= MigtMj_i;
+
+    Merge_pointers : entity work.merge_counters(Behavioral)
+        Port Map(clk => clk,
+                 N => N_in(12 downto 0),
+                 MigtMj => MigtMj_i,
+                 Lw => Lw,
+                 Lp => Lp,
+                 Em => Em,
+                 Enp => Enp,
+                 Ew => Ew,
+                 inext => inext,
+                 jnext => jnext,
+                 k => kaddr,
+                 take => take,
+                 zk => zk,
+                 zlo => zlo,
+                 zw => zw);
+
+    Radix_pointers : entity work.radix_counters(Behavioral)
+        Generic Map(DATA_WIDTH => DATA_WIDTH,
+                    KEY_WIDTH => KEY_WIDTH,
+                    RADIX_BITS => RADIX_BITS)
+        Port Map(clk => clk,
+                 N => N_in(12 downto 0),
+                 K => K_in(12 downto 0),
+                 sel => rsel,
+                 Mi => Mi,
+                 Lr => Lr,
+                 Rc => Rc,
+                 Rp => Rp,
+                 Rs => Rs,
+                 Lc => Lc,
+                 Enr => Enr,
+                 c_addr => raddr,
+                 k => rk,
+                 kdata => rdata,
+                 kwe => rwe,
+                 zc => zc,
+                 zb => zb,
+                 zp => zp);
+
+    --merge or radix scatter output to the other bank
+    dinc <= rdata when (radix = '1') else
+            Mi when (take = '1') else Mj;
+    addrc <= rk when (radix = '1') else kaddr;
+    wec <= Em or rwe;
+    merge <= '1' when (alg = ALG_MERGE) else '0';
+    radix <= '1' when (alg = ALG_RADIX or alg = ALG_SELECT) else '0';
+    rsel <= '1' when (alg = ALG_SELECT) else '0';
+    
+    --the host uses the current bank only while s = '0' and db = '0'
+    eng <= s or db;
+    hwea <= WrInit and db;
+    hweb <= WrInitB and db;
+    
+    --multiplexing for addresses of RAM
+    AddrA <= inext when (eng = '1' and merge = '1') else
+             raddr when (eng = '1' and radix = '1') else
+             icounter_out when (eng = '1') else RAdd;
+    AddrB <= RAddB when (eng = '0') else
+             jnext when (merge = '1') else
+             minidx when (Wr = '1') else
+             std_logic_vector(unsigned(icounter_out) + 1) when (Lj = '1') else jcounter_out;
     
-    --multiplexing for address A of RAM
-    AddrA <= icounter_out when (s = '1') else RAdd;
+    --multiplexing for address dina of RAM (minimum into M[i] while sorting)
+    dina <= minv when (eng = '1') else DataIn;
     
-    --multiplexing for address dina of RAM
-    dina <= Mj when (s = '1') else DataIn;
+    --multiplexing for port B data of RAM (Mi while sorting)
+    dinb <= Mi when (eng = '1') else DataInB;
     
-    --multiplexing for wea of RAM
-    wea <= Wr when (s = '1') else WrInit;
+    --multiplexing for write enables of RAM
+    wea <= (Wr and found) when (eng = '1') else WrInit;
+    web <= (Wr and found) when (eng = '1') else WrInitB;
     
     --multiplexing controlled by RdDone
-    done_mux_out <= "000000000000000" & Done when (addr_ctrl = '1') else Mi;
+    done_mux_out <= "000000000000000" & Done when (addr_ctrl = '1') else
+                    std_logic_vector(resize(unsigned(Mi), 16));
     
     --multiplexing controlled by Rd
     DataOut <= done_mux_out when (Rd = '1') else (others => '0');
+    HostA <= hdouta when (db = '1') else Mi;
+    HostB <= hdoutb when (db = '1') else Mj;
     
 end Behavioral;
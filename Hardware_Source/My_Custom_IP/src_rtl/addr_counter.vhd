@@ -13,6 +13,8 @@ use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
 entity addr_counter is
     Port (clk, en, ld : in std_logic;
+          d : in std_logic_vector(12 downto 0); --value loaded by ld
+          step : in std_logic_vector(2 downto 0); --elements per access (1, 2 or 4)
           Q : out std_logic_vector(12 downto 0)
           );
 end addr_counter;
@@ -24,9 +26,9 @@ begin
     begin
         if(rising_edge(clk)) then
 			if(ld = '1') then
-		        count <= (OTHERS => '0'); --Load 0 to counter
+		        count <= unsigned(d); --Load d (0 or an address) to counter
 			elsif (en = '1') then
-			    count <= count + 1;
+			    count <= count + unsigned(step);
             end if;
         end if;
     end process;
@@ -0,0 +1,136 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 04/27/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: check_unit - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Result check of the sorting core, so the host needs no reference sort.
+--  * load: count, sum and XOR of every key written through the host ports
+--    (up to two per clock), cleared by init_write
+--  * readback: the same of every key returned by a read that advances ri
+--    (one, two or four keys per access), cleared by init_read; each key must
+--    not be smaller than the one read before it
+-- sorted = no key out of order since init_read; match = the keys read back
+-- are the keys loaded as a multiset (count, sum mod 2^32 and XOR agree),
+-- valid once all N elements have been read.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+entity check_unit is
+    Port (clk : in std_logic;
+          clr_in, clr_out : in std_logic; --init_write, init_read
+          --keys written by the host ports (pack_unit)
+          WeA, WeB : in std_logic;
+          KeyA, KeyB : in std_logic_vector(31 downto 0);
+          --keys read by the host
+          R1, R2, R4 : in std_logic; --one key, two 16-bit keys, four 8-bit keys
+          Key1 : in std_logic_vector(31 downto 0);
+          Word2, Word4 : in std_logic_vector(31 downto 0);
+          --status
+          sorted, match : out std_logic);
+end check_unit;
+
+architecture Behavioral of check_unit is
+    type key_array is array (0 to 3) of unsigned(31 downto 0);
+    signal k : key_array;
+    signal nk : integer range 0 to 4;
+    signal cnt_in, cnt_out : unsigned(15 downto 0) := (others => '0');
+    signal sum_in, sum_out, xor_in, xor_out : unsigned(31 downto 0) := (others => '0');
+    signal last : unsigned(31 downto 0);
+    signal have_last, bad : std_logic := '0';
+begin
+
+    --keys of the current read, ascending positions
+    process(R1, R2, R4, Key1, Word2, Word4)
+    begin
+        k <= (others => (others => '0'));
+        nk <= 0;
+        if (R1 = '1') then
+            k(0) <= unsigned(Key1);
+            nk <= 1;
+        elsif (R2 = '1') then
+            k(0) <= resize(unsigned(Word2(15 downto 0)), 32);
+            k(1) <= resize(unsigned(Word2(31 downto 16)), 32);
+            nk <= 2;
+        elsif (R4 = '1') then
+            for i in 0 to 3 loop
+                k(i) <= resize(unsigned(Word4(8*i+7 downto 8*i)), 32);
+            end loop;
+            nk <= 4;
+        end if;
+    end process;
+
+    process(clk)
+        variable s, x : unsigned(31 downto 0);
+        variable ok : std_logic;
+    begin
+        if rising_edge(clk) then
+            --load side
+            s := sum_in;
+            x := xor_in;
+            if (WeA = '1') then
+                s := s + unsigned(KeyA);
+                x := x xor unsigned(KeyA);
+            end if;
+            if (WeB = '1') then
+                s := s + unsigned(KeyB);
+                x := x xor unsigned(KeyB);
+            end if;
+            if (WeA = '1' and WeB = '1') then
+                cnt_in <= cnt_in + 2;
+            elsif (WeA = '1' or WeB = '1') then
+                cnt_in <= cnt_in + 1;
+            end if;
+            sum_in <= s;
+            xor_in <= x;
+            if (clr_in = '1') then
+                cnt_in <= (others => '0');
+                sum_in <= (others => '0');
+                xor_in <= (others => '0');
+            end if;
+
+            --readback side
+            s := sum_out;
+            x := xor_out;
+            ok := '1';
+            for i in 0 to 3 loop
+                if (i < nk) then
+                    s := s + k(i);
+                    x := x xor k(i);
+                    if (i > 0 and k(i-1) > k(i)) then
+                        ok := '0';
+                    end if;
+                end if;
+            end loop;
+            if (nk > 0) then
+                if (have_last = '1' and last > k(0)) then
+                    ok := '0';
+                end if;
+                last <= k(nk - 1);
+                have_last <= '1';
+                cnt_out <= cnt_out + nk;
+            end if;
+            sum_out <= s;
+            xor_out <= x;
+            if (ok = '0') then
+                bad <= '1';
+            end if;
+            if (clr_out = '1') then
+                cnt_out <= (others => '0');
+                sum_out <= (others => '0');
+                xor_out <= (others => '0');
+                have_last <= '0';
+                bad <= '0';
+            end if;
+        end if;
+    end process;
+
+    sorted <= not bad;
+    match <= '1' when (cnt_in = cnt_out and sum_in = sum_out and xor_in = xor_out) else '0';
+
+end Behavioral;
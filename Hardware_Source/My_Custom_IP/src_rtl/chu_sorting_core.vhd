@@ -9,12 +9,101 @@
 -- Tool Versions: Vivado 2023.x / Vitis 2023.x
 ----------------------------------------------------------------------------------
 --Top-Level Wrapper matching the interface of an MMIO core
+--NET_LANES = 0 : Sorting_datapath + controller, algorithm selected by
+--               CTRL_REG bits 5..3 (latched on every CTRL_REG write):
+--               ALG_SELECTION ~N^2/2 clocks, ALG_MERGE ~N log2 N clocks,
+--               ALG_RADIX: LSD radix sort on RADIX_BITS-bit digits (8 or 4),
+--               ~2 N clocks per digit whatever the input order,
+--               ALG_SELECT: MEM[K-1] <= K-th smallest element (K_REG) by
+--               MSD radix selection, ~2 N clocks, rest of MEM unspecified,
+--               ALG_STREAM: MEMW_ri pushes into stream_heap, MEMR_ri pops the
+--               smallest element, so no separate sort phase is needed
+--               ALG_HIST: MEMR_ri returns the counting sort of the low 8
+--               key bits from the histogram (any NET_LANES/SEL_LANES)
+--SEL_LANES > 1 : (NET_LANES = 0) Banked_datapath, the selection sort examines
+--               SEL_LANES elements per clock (~N^2/(2 SEL_LANES) clocks);
+--               ALG_MERGE/ALG_RADIX/ALG_SELECT fall back to the selection
+--               sort (partial with K), no host bank
+--NET_LANES > 0 : bitonic sorting network (Network_datapath + network_controller)
+--               with NET_LANES compare-exchange lanes (power of 2, 1..16),
+--               ~ lgN*(lgN+1)/2 * N/NET_LANES clocks (N=8192, 16 lanes: 46.6K)
+--Registers: 0 MEMW_ri, 1 MEMR_ri, 2 N, 3 CTRL, 4 STATUS,
+--           5/6 MEMW2/MEMR2 (2 x 16-bit), 7/8 MEMW4/MEMR4 (4 x 8-bit), ri += 2/4
+--           9 BANK: bit 0 db (host bank mode), bit 1 swap host/current bank
+--           (ignored while s = '1' or without a host bank); STATUS bit 1 =
+--           host bank present (HOST_BANK)
+--           10 IRQ: bit 0 interrupt enable, any write clears the pending
+--           flag (STATUS bit 2), which is set by the rising edge of Done;
+--           irq = pending and enable (MCS external interrupt, level)
+--           11 KEY: key of MEM[ri] (up to 32 bits), ri unchanged
+--           12 MEMRX: index of MEM[ri], ri++
+--           13 HIST: histogram entry of bucket ri(7..0), ri++; the low 8
+--           key bits of every element loaded since init_write are counted
+--           during the load (hist_unit), in all modes
+--           14 K: partial sort, the selection sort engines stop once
+--           MEM[0..K-1] holds the K smallest elements (~N K clocks);
+--           0 (reset) sorts all N, the other engines always sort all N
+--           STATUS bit 3 = INDEX, bits 13..8 = KEY_WIDTH
+--           15 GEN: fill MEM[0..N-1] from the on-core generator (gen_unit),
+--           one element per clock; bits 1..0 pattern (LFSR, descending,
+--           ascending, few unique), bit 2 8-bit data, bits 31..16 seed;
+--           starts a new data set like init_write, STATUS bit 6 = busy
+--           STATUS bit 7 = stream_heap present (NET_LANES = 0); without it
+--           ALG_STREAM is sorted by the network like any other algorithm
+--           16 ADDR: write sets ri (random access), read returns ri
+--           17 DATA: key of MEM[ri] (read) or MEM[ri] <= key (write) in any
+--           mode, ri unchanged; ADDR + DATA = 2 accesses per element
+--           STATUS bit 4 = SORTED: every key read back since init_read
+--           (MEMR_ri/MEMRX/MEMR2/MEMR4) was >= the one before it;
+--           bit 5 = CHECK: the keys read back and the keys loaded since
+--           init_write agree in count, sum and XOR (check_unit)
+--Records: KEY_WIDTH (8..32) sets the key width, MEMW_ri takes a key of up
+--to 32 bits. With INDEX = true each element also carries its load address
+--(13 bits) below the key; it moves with the key through every engine and
+--breaks ties, so MEMRX returns the permutation (sorted position -> load
+--position). Word width KEY_WIDTH (+13): 8K x 45 bits for 32-bit records.
+--BRAM_BUDGET: RAMB36 left for the core (XC7A35T: 50, minus 32 for the
+--128 KB MCS memory). Elaboration fails when bram36_estimate() of the
+--generics exceeds it: with two banks up to KEY_WIDTH = 20 fits, INDEX needs
+--a smaller MCS memory (64 KB: BRAM_BUDGET = 34, up to KEY_WIDTH = 24) or one
+--copy: SEL_LANES > 1 up to KEY_WIDTH = 20, NET_LANES > 0 up to 32 (13).
+--Double buffering (NET_LANES = 0, SEL_LANES = 1, HOST_BANK = true, off by
+--default: the third 8K-word bank costs 4 RAMB36 at 16 bits, and the core
+--already shares the XC7A35T's 50 RAMB36 with the 128 KB MCS memory; see the
+--README for the BRAM budget): with db = '1' the MEMW/MEMR registers
+--use the host bank of dual_bank_RAM, independent of s, so batch k+1 is
+--loaded and batch k-1 read back while batch k is sorting
+--Memory window: win_cs selects the window (video slot V4 of the FPro bus),
+--word k is MEM[k] on host port A, so the CPU builds the data set and reads
+--the result in place (write/read/wr_data are the shared bus lines). Same
+--bank as MEMW/MEMR: s = '0', or any time in the host bank with db = '1'.
+--A read returns the key of MEM[win_addr] on the clock after the strobe
+--(synchronous BRAM read), unlike the slot registers, whose data is valid in
+--the strobe clock: chu_mcs_bridge holds io_ready low in the strobe clock of
+--a video read, so the MCS samples it one clock later. Reads count in the
+--readback check
+--Bus wait: pack_unit, stream_heap and hist_unit need HOST_GAP (4) clocks
+--from one access of the slot or the window to the next. ready = '0' while
+--cs or win_cs selects the core closer than that; chu_mcs_bridge then holds
+--the strobe and io_ready, so back-to-back MCS accesses are safe
+--Phase strobes (phase, to the cap inputs of chu_timer): one-clock pulses
+--at 0 init_write/GEN (load start), 1 every element written (the last one
+--ends the load), 2 sort start (s rises), 3 Done rises, 4 init_read
+--(readback start), 5 every element read back (the last one ends it)
 
 library IEEE;
 use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
 
 entity chu_sorting_core is
+    Generic(NET_LANES : integer := 0;
+            SEL_LANES : integer := 1;
+            KEY_WIDTH : integer := 16;
+            INDEX : boolean := false;
+            RADIX_BITS : integer := 8; --ALG_RADIX digit width (8: 2 passes for 16-bit keys, 4: 4 passes)
+            HOST_BANK : boolean := false; --third RAM bank for double buffering (BANK_REG)
+            BRAM_BUDGET : integer := 18); --RAMB36 available to the core
     Port (clk     : in  std_logic; 
           reset   : in  std_logic; 
           -- io bridge interface
@@ -23,68 +112,401 @@ entity chu_sorting_core is
           read    : in  std_logic;
           addr    : in  std_logic_vector(4 downto 0);
           rd_data : out std_logic_vector(31 downto 0);
-          wr_data : in  std_logic_vector(31 downto 0));
+          wr_data : in  std_logic_vector(31 downto 0);
+          -- memory window: word k = MEM[k]
+          win_cs      : in  std_logic;
+          win_addr    : in  std_logic_vector(12 downto 0);
+          win_rd_data : out std_logic_vector(31 downto 0);
+          -- phase strobes (timer capture)
+          phase   : out std_logic_vector(5 downto 0);
+          -- bus wait (chu_mcs_bridge fp_ready)
+          ready   : out std_logic;
+          -- Done interrupt
+          irq     : out std_logic);
 
 end chu_sorting_core;
 
 architecture Behavioral of chu_sorting_core is
-    signal s, MigtMj, zi, zj, Wr, Li, Ei, Lj, Ej : std_logic;
-    signal Wrs, WrN, Wrl, WrInit, WrMem, Rd : std_logic;
+    constant DW : integer := word_width(KEY_WIDTH, INDEX); --element word
+    --8K-word memory copies: current/other (+ host) bank, or the lane banks
+    constant SEQ : boolean := NET_LANES = 0 and SEL_LANES = 1;
+    constant COPIES : integer := 1 + boolean'pos(SEQ) + boolean'pos(SEQ and HOST_BANK);
+    constant BRAM36 : integer := bram36_estimate(DW, COPIES, NET_LANES = 0);
+    signal s, MigtMj, zi, zj, zn, Wr, Li, Ei, Lj, Ej, Emin : std_logic;
+    signal Wrs, WrN, WrK, Wrl, WrInit, WrMem, Rd : std_logic;
     signal Eri, Lri : std_logic;
     signal Done : std_logic;
     signal temp : std_logic_vector(2 downto 0);
     signal DataOut : std_logic_vector(15 downto 0);
     signal s_reg : std_logic;
-    signal write_reg : std_logic_vector(31 downto 0);
-    signal n_reg : std_logic_vector(15 downto 0);
+    signal n_reg, k_reg : std_logic_vector(15 downto 0);
     signal WrInit_r, Rd_r, RdMem, RdStatus : std_logic;
     signal ri : std_logic_vector(12 downto 0);
+    signal lgk, lgj : std_logic_vector(3 downto 0);
+    signal p : std_logic_vector(11 downto 0);
+    signal First, Wb : std_logic;
+    signal alg_r, alg_c : std_logic_vector(2 downto 0);
+    signal Lw, Lp, Em, Enp, Ew, zk, zlo, zw : std_logic;
+    signal Lr, Rc, Rp, Rs, Lc, Enr, zc, zb, zp : std_logic;
+    signal stream, heap_clr, heap_push, heap_pop : std_logic;
+    signal hist, hist_start, hist_pop, RdHist : std_logic;
+    signal hist_top : std_logic_vector(7 downto 0);
+    signal hist_count : std_logic_vector(MEM_ADDR_WIDTH downto 0);
+    signal hkeyA, hkeyB : std_logic_vector(31 downto 0);
+    signal out_key : std_logic_vector(31 downto 0);
+    signal chk_r1, chk_r2, chk_r4, chk_sorted, chk_match : std_logic;
+    signal WrGen, gen_we, gen_busy, W1 : std_logic;
+    signal gen_data, pk_data : std_logic_vector(31 downto 0);
+    signal WinWr, WinRd, win_rd_r : std_logic;
+    signal WrAddr, RdAddr, WrData, RdData : std_logic;
+    signal ri_d : std_logic_vector(12 downto 0);
+    signal heap_top : std_logic_vector(DW-1 downto 0);
+    signal WrP2, WrP4, RdP2, RdP4 : std_logic;
+    signal ri_step : std_logic_vector(2 downto 0);
+    signal HAddrA, HAddrB : std_logic_vector(12 downto 0);
+    signal HDinA, HDinB, HostA, HostB : std_logic_vector(DW-1 downto 0);
+    signal Rd1 : std_logic_vector(31 downto 0);
+    signal RdX : std_logic_vector(IDX_WIDTH-1 downto 0);
+    signal RdKey, RdIdx, ix : std_logic;
+    signal status : std_logic_vector(31 downto 0);
+    signal HWeA, HWeB, W2, W4 : std_logic;
+    signal Rd2, Rd4 : std_logic_vector(31 downto 0);
+    signal WrBank, db, hswap, hb, sh : std_logic;
+    signal WrIrq, ie, irq_pend, done_r : std_logic;
+    signal acc : std_logic;
+    signal gap : integer range 0 to HOST_GAP-1;
 begin
 
+    assert BRAM36 <= BRAM_BUDGET
+        report "chu_sorting_core: KEY_WIDTH/INDEX/HOST_BANK need about " & integer'image(BRAM36) &
+               " RAMB36, BRAM_BUDGET is " & integer'image(BRAM_BUDGET)
+        severity failure;
+
+  sel_gen : if NET_LANES = 0 generate
+   seq_gen : if SEL_LANES = 1 generate
+    hb <= '1' when HOST_BANK else '0';
     --instantiation of sorting datapath
     sort_datapath_unit : entity work.Sorting_datapath
+        Generic Map(DATA_WIDTH => DW,
+                    KEY_WIDTH => KEY_WIDTH,
+                    RADIX_BITS => RADIX_BITS,
+                    HOST_BANK => HOST_BANK)
         Port Map(clk => clk,
-                 DataIn => write_reg(15 downto 0),
-                 RAdd => ri,
+                 DataIn => HDinA, --host port A (pack_unit)
+                 RAdd => HAddrA,
+                 WrInitB => HWeB,
+                 DataInB => HDinB,
+                 RAddB => HAddrB,
+                 db => db,
+                 hswap => hswap,
                  N_in => n_reg,
-                 WrInit => WrInit,
+                 K_in => k_reg,
+                 WrInit => HWeA,
                  Rd => Rd,
+                 alg => alg_r,
                  Wr => Wr,
                  Li => Li,
                  Ei => Ei,
                  Lj => Lj,
                  Ej => Ej,
+                 Emin => Emin,
+                 Lw => Lw,
+                 Lp => Lp,
+                 Em => Em,
+                 Enp => Enp,
+                 Ew => Ew,
+                 Lr => Lr,
+                 Rc => Rc,
+                 Rp => Rp,
+                 Rs => Rs,
+                 Lc => Lc,
+                 Enr => Enr,
                  MigtMj => MigtMj,
                  zi => zi,
                  zj => zj,
+                 zn => zn,
+                 zk => zk,
+                 zlo => zlo,
+                 zw => zw,
+                 zc => zc,
+                 zb => zb,
+                 zp => zp,
                  s => s,
                  Done => Done,
                  addr_ctrl => addr(2),              
-                 DataOut => DataOut);
-    --slot interface 
-    rd_data(15 downto 0) <= DataOut;    
-    rd_data(31 downto 16) <= (others => '0'); 
-    
-    -- input data register process
-    process(clk, reset)
+                 DataOut => DataOut,
+                 HostA => HostA,
+                 HostB => HostB);
+   end generate;
+
+   --selection sort over SEL_LANES banks, no merge engine or host bank
+   par_gen : if SEL_LANES > 1 generate
+    hb <= '0'; --no host bank, BANK_REG has no effect
+    bank_datapath_unit : entity work.Banked_datapath
+        Generic Map(LANES => SEL_LANES,
+                    DATA_WIDTH => DW)
+        Port Map(clk => clk,
+                 DataIn => HDinA, --host port A (pack_unit)
+                 RAdd => HAddrA,
+                 WrInitB => HWeB,
+                 DataInB => HDinB,
+                 RAddB => HAddrB,
+                 N_in => n_reg,
+                 K_in => k_reg,
+                 WrInit => HWeA,
+                 Rd => Rd,
+                 Wr => Wr,
+                 Li => Li,
+                 Ei => Ei,
+                 Lj => Lj,
+                 Ej => Ej,
+                 Emin => Emin,
+                 MigtMj => MigtMj,
+                 zi => zi,
+                 zj => zj,
+                 zn => zn,
+                 s => s,
+                 Done => Done,
+                 addr_ctrl => addr(2),
+                 DataOut => DataOut,
+                 HostA => HostA,
+                 HostB => HostB);
+    zk <= '0';
+    zlo <= '0';
+    zw <= '0';
+    zc <= '0';
+    zb <= '0';
+    zp <= '0';
+   end generate;
+
+   --instantiation of controller
+   sort_controller_unit : entity work.controller
+        Port Map(clk => clk,
+                 reset => reset,
+                 s => s,
+                 alg => alg_c,
+                 MigtMj => MigtMj,
+                 zi => zi,
+                 zj => zj,
+                 zn => zn,
+                 zk => zk,
+                 zlo => zlo,
+                 zw => zw,
+                 zc => zc,
+                 zb => zb,
+                 zp => zp,
+                 Wr => Wr,
+                 Li => Li,
+                 Ei => Ei,
+                 Lj => Lj,
+                 Ej => Ej,
+                 Emin => Emin,
+                 Done => Done,
+                 Lw => Lw,
+                 Lp => Lp,
+                 Em => Em,
+                 Enp => Enp,
+                 Ew => Ew,
+                 Lr => Lr,
+                 Rc => Rc,
+                 Rp => Rp,
+                 Rs => Rs,
+                 Lc => Lc,
+                 Enr => Enr);
+
+   --instantiation of streaming heap
+   stream_heap_unit : entity work.stream_heap
+        Generic Map(DATA_WIDTH => DW)
+        Port Map(clk => clk,
+                 clr => heap_clr,
+                 push => heap_push,
+                 pop => heap_pop,
+                 DataIn => HDinA, --key and index as stored by pack_unit
+                 top => heap_top);
+  end generate;
+
+  net_stream_gen : if NET_LANES > 0 generate
+    heap_top <= (others => '0');
+  end generate;
+
+    --the banked datapath has no merge or radix engine: they run the selection sort
+    alg_c <= ALG_SELECTION when (SEL_LANES > 1 and (alg_r = ALG_MERGE or alg_r = ALG_RADIX or
+                                                 alg_r = ALG_SELECT)) else alg_r;
+    stream <= '1' when (alg_r = ALG_STREAM and NET_LANES = 0) else '0';
+    heap_clr <= (Wrl and wr_data(2)) or WrGen; --init_write or the generator starts a new data set
+    heap_push <= stream and (WrInit or gen_we);
+    heap_pop <= stream and Rd_r and (RdMem or RdIdx);
+
+    --histogram and counting sort of the low key byte
+    hist_unit_inst : entity work.hist_unit
+        Port Map(clk => clk,
+                 clr => heap_clr,
+                 WeA => HWeA,
+                 WeB => HWeB,
+                 KeyA => hkeyA(7 downto 0),
+                 KeyB => hkeyB(7 downto 0),
+                 start => hist_start,
+                 pop => hist_pop,
+                 top => hist_top,
+                 hidx => ri(7 downto 0),
+                 count => hist_count);
+    hkeyA <= key_of(HDinA, KEY_WIDTH);
+    hkeyB <= key_of(HDinB, KEY_WIDTH);
+    hist <= '1' when (alg_r = ALG_HIST) else '0';
+    hist_start <= Wrl and not wr_data(2); --init_read
+    hist_pop <= hist and Rd_r and RdMem;
+
+    --test data generator (host port A at one element per clock)
+    gen_unit_inst : entity work.gen_unit
+        Port Map(clk => clk,
+                 reset => reset,
+                 start => WrGen,
+                 cfg => wr_data,
+                 N => n_reg(12 downto 0),
+                 slow => stream,
+                 we => gen_we,
+                 data => gen_data,
+                 busy => gen_busy);
+
+    --order and checksum of the data set
+    check_unit_inst : entity work.check_unit
+        Port Map(clk => clk,
+                 clr_in => heap_clr,
+                 clr_out => hist_start,
+                 WeA => HWeA,
+                 WeB => HWeB,
+                 KeyA => hkeyA,
+                 KeyB => hkeyB,
+                 R1 => chk_r1,
+                 R2 => chk_r2,
+                 R4 => chk_r4,
+                 Key1 => out_key,
+                 Word2 => Rd2,
+                 Word4 => Rd4,
+                 sorted => chk_sorted,
+                 match => chk_match);
+    out_key <= win_rd_data when (win_rd_r = '1') else
+               key_of(heap_top, KEY_WIDTH) when (stream = '1') else
+               x"000000" & hist_top when (hist = '1') else Rd1;
+    chk_r1 <= (Rd_r and (RdMem or RdIdx)) or win_rd_r;
+    chk_r2 <= Rd_r and RdP2;
+    chk_r4 <= Rd_r and RdP4;
+
+  net_gen : if NET_LANES > 0 generate
+    hb <= '0'; --no host bank, BANK_REG has no effect
+    --instantiation of sorting network datapath
+    net_datapath_unit : entity work.Network_datapath
+        Generic Map(LANES => NET_LANES,
+                    DATA_WIDTH => DW)
+        Port Map(clk => clk,
+                 DataIn => HDinA,
+                 RAdd => HAddrA,
+                 WrInitB => HWeB,
+                 DataInB => HDinB,
+                 RAddB => HAddrB,
+                 N_in => n_reg,
+                 WrInit => HWeA,
+                 Rd => Rd,
+                 lgk => lgk,
+                 lgj => lgj,
+                 p => p,
+                 First => First,
+                 Wb => Wb,
+                 s => s,
+                 Done => Done,
+                 addr_ctrl => addr(2),
+                 DataOut => DataOut,
+                 HostA => HostA,
+                 HostB => HostB);
+
+   --instantiation of network controller
+   net_controller_unit : entity work.network_controller
+        Generic Map(LANES => NET_LANES)
+        Port Map(clk => clk,
+                 reset => reset,
+                 s => s,
+                 N_in => n_reg,
+                 lgk => lgk,
+                 lgj => lgj,
+                 p => p,
+                 First => First,
+                 Wb => Wb,
+                 Done => Done);
+  end generate;
+
+    --host ports of the memory: single and packed transfers
+   pack_unit_inst : entity work.pack_unit
+        Generic Map(KEY_WIDTH => KEY_WIDTH,
+                    INDEX => INDEX)
+        Port Map(clk => clk,
+                 ri => ri,
+                 W1 => W1,
+                 W2 => W2,
+                 W4 => W4,
+                 wr_data => pk_data,
+                 WA => win_addr,
+                 WW => WinWr,
+                 WR => WinRd,
+                 AddrA => HAddrA,
+                 AddrB => HAddrB,
+                 DinA => HDinA,
+                 DinB => HDinB,
+                 WeA => HWeA,
+                 WeB => HWeB,
+                 DoutA => HostA,
+                 DoutB => HostB,
+                 Rd1 => Rd1,
+                 RdX => RdX,
+                 Rd2 => Rd2,
+                 Rd4 => Rd4);
+    W1 <= WrInit or gen_we or WrData;
+    pk_data <= gen_data when (gen_busy = '1') else wr_data;
+    W2 <= WrInit_r and WrP2;
+    W4 <= WrInit_r and WrP4;
+
+    --memory window: RAM port A output one clock after the read strobe, the
+    --bridge delays io_ready of video reads by one clock to sample it
+    WinWr <= win_cs and write;
+    WinRd <= win_cs and read;
+    win_rd_data <= key_of(HostA, KEY_WIDTH);
+    process(clk)
     begin
-        if (reset = '1') then
-            write_reg <= (others => '0');
-        elsif rising_edge(clk) then
-            if (WrInit = '1') then
-                write_reg <= wr_data;
-            end if;
+        if rising_edge(clk) then
+            win_rd_r <= WinRd;
         end if;
     end process;
+
+    --slot interface 
+    ix <= '1' when INDEX else '0';
+    sh <= '1' when NET_LANES = 0 else '0'; --stream_heap present
+    status <= x"0000" & "00" & std_logic_vector(to_unsigned(KEY_WIDTH, 6)) &
+              sh & gen_busy & chk_match & chk_sorted & ix & irq_pend & hb & DataOut(0);
+    rd_data <= status when (RdStatus = '1') else
+               x"0000" & "000" & ri when (RdAddr = '1') else
+               Rd1 when (RdData = '1') else
+               key_of(heap_top, KEY_WIDTH) when (stream = '1' and (RdMem = '1' or RdKey = '1')) else
+               x"0000" & "000" & index_of(heap_top, INDEX) when (stream = '1' and RdIdx = '1') else
+               x"000000" & hist_top when (hist = '1' and RdMem = '1') else
+               x"0000" & "00" & hist_count when (RdHist = '1') else
+               Rd1 when (Rd_r = '1' and (RdMem = '1' or RdKey = '1')) else
+               x"0000" & "000" & RdX when (Rd_r = '1' and RdIdx = '1') else
+               Rd2 when (Rd_r = '1' and RdP2 = '1') else
+               Rd4 when (Rd_r = '1' and RdP4 = '1') else
+               (others => '0');
     
     -- ri counter
    ri_counter : entity work.addr_counter
         Port Map (clk => clk,
                   en => Eri,
                   ld => Lri,
+                  d => ri_d,
+                  step => ri_step,
                   Q => ri);
-   Eri <= WrMem or RdMem;
-   Lri <= Wrl;
+   Eri <= WrMem or RdMem or WrP2 or RdP2 or WrP4 or RdP4 or RdIdx or RdHist or gen_we;
+   Lri <= Wrl or WrGen or WrAddr;
+   ri_d <= wr_data(12 downto 0) when (WrAddr = '1') else (others => '0');
+   ri_step <= "010" when (WrP2 = '1' or RdP2 = '1') else
+              "100" when (WrP4 = '1' or RdP4 = '1') else "001";
                  
    -- signal s register
     process(clk, reset)
@@ -98,6 +520,76 @@ begin
         end if;
     end process;
     
+   -- algorithm select register, written with every CTRL_REG access
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            alg_r <= ALG_SELECTION;
+        elsif rising_edge(clk) then
+            if (Wrs = '1' or Wrl = '1') then
+                alg_r <= wr_data(5 downto 3);
+            end if;
+        end if;
+    end process;
+    
+   -- bank register: host bank mode and bank swap
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            db <= '0';
+        elsif rising_edge(clk) then
+            if (WrBank = '1' and hb = '1') then
+                db <= wr_data(0);
+            end if;
+        end if;
+    end process;
+    hswap <= WrBank and wr_data(1) and hb and not s;
+    
+   -- Done interrupt: enable, pending flag set on the rising edge of Done
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            ie <= '0';
+            irq_pend <= '0';
+            done_r <= '0';
+        elsif rising_edge(clk) then
+            done_r <= Done;
+            if (WrIrq = '1') then
+                ie <= wr_data(0);
+            end if;
+            if (Done = '1' and done_r = '0') then
+                irq_pend <= '1';
+            elsif (WrIrq = '1') then
+                irq_pend <= '0';
+            end if;
+        end if;
+    end process;
+    irq <= irq_pend and ie;
+
+   -- access spacing: clocks since the last access of the slot or the window
+    acc <= (cs or win_cs) and (read or write);
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            gap <= HOST_GAP-1;
+        elsif rising_edge(clk) then
+            if (acc = '1') then
+                gap <= 0;
+            elsif (gap < HOST_GAP-1) then
+                gap <= gap + 1;
+            end if;
+        end if;
+    end process;
+    ready <= '0' when ((cs = '1' or win_cs = '1') and gap < HOST_GAP-1) else '1';
+
+   -- phase strobes
+    phase(0) <= (Wrl and wr_data(2)) or WrGen;
+    phase(1) <= HWeA or HWeB;
+    phase(2) <= Wrs and wr_data(0) and not s;
+    phase(3) <= Done and not done_r;
+    phase(4) <= Wrl and not wr_data(2);
+    phase(5) <= chk_r1 or chk_r2 or chk_r4;
+    
    -- input N address register
     process(clk, reset)
     begin
@@ -109,6 +601,18 @@ begin
             end if;
         end if;
     end process;
+
+   -- partial sort K register
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            k_reg <= (others => '0');
+        elsif rising_edge(clk) then
+            if (WrK = '1') then
+                k_reg <= wr_data(15 downto 0);
+            end if;
+        end if;
+    end process;
    
    -- WrInit register and logic
    process(clk, reset)
@@ -135,29 +639,31 @@ begin
         end if;
    end process;
    Rd <= (Rd_r and RdMem) or RdStatus; 
-            
-   --instantiation of controller
-   sort_controller_unit : entity work.controller
-        Port Map(clk => clk,
-                 reset => reset,
-                 s => s,
-                 MigtMj => MigtMj,
-                 zi => zi,
-                 zj => zj,
-                 Wr => Wr,
-                 Li => Li,
-                 Ei => Ei,
-                 Lj => Lj,
-                 Ej => Ej,
-                 Done => Done);
-            
+
     --Combinational logic for MMIO wrapper control signals
     temp <= cs & write & read;
-    WrN <= '1' when (temp = "110") and (addr(2 downto 0) = "010") else '0';
-    Wrs <= '1' when (temp = "110") and (addr(2 downto 0) = "011") and (wr_data(1) = '0') else '0';
-    Wrl <= '1' when (temp = "110") and (addr(2 downto 0) = "011") and (wr_data(1 downto 0) = "10") else '0';
-    WrMem <= '1' when (temp = "110") and (addr(2 downto 0) = "000") else '0';
-    RdMem <= '1' when (temp = "101") and (addr(2 downto 0) = "001") else '0';
-    RdStatus <= '1' when (temp = "101") and (addr(2 downto 0) = "100") else '0';
+    WrN <= '1' when (temp = "110") and (addr = "00010") else '0';
+    WrK <= '1' when (temp = "110") and (addr = "01110") else '0';
+    Wrs <= '1' when (temp = "110") and (addr = "00011") and (wr_data(1) = '0') else '0';
+    Wrl <= '1' when (temp = "110") and (addr = "00011") and (wr_data(1 downto 0) = "10") else '0';
+    WrMem <= '1' when (temp = "110") and (addr = "00000") else '0';
+    RdMem <= '1' when (temp = "101") and (addr = "00001") else '0';
+    RdStatus <= '1' when (temp = "101") and (addr = "00100") else '0';
+    --packed transfers: 2 x 16-bit and 4 x 8-bit elements per word
+    WrP2 <= '1' when (temp = "110") and (addr = "00101") else '0';
+    RdP2 <= '1' when (temp = "101") and (addr = "00110") else '0';
+    WrP4 <= '1' when (temp = "110") and (addr = "00111") else '0';
+    RdP4 <= '1' when (temp = "101") and (addr = "01000") else '0';
+    WrBank <= '1' when (temp = "110") and (addr = "01001") else '0';
+    WrIrq <= '1' when (temp = "110") and (addr = "01010") else '0';
+    WrGen <= '1' when (temp = "110") and (addr = "01111") else '0';
+    RdKey <= '1' when (temp = "101") and (addr = "01011") else '0';
+    RdIdx <= '1' when (temp = "101") and (addr = "01100") else '0';
+    RdHist <= '1' when (temp = "101") and (addr = "01101") else '0';
+    --random access: address register and data port
+    WrAddr <= '1' when (temp = "110") and (addr = "10000") else '0';
+    RdAddr <= '1' when (temp = "101") and (addr = "10000") else '0';
+    WrData <= '1' when (temp = "110") and (addr = "10001") else '0';
+    RdData <= '1' when (temp = "101") and (addr = "10001") else '0';
     
 end Behavioral;
@@ -0,0 +1,40 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/02/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: compare_exchange - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- One compare-exchange lane of the sorting network, built on Comparator.
+-- L goes to the lower element index: min(A,B) when asc = '1', max(A,B)
+-- otherwise; H receives the other value.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+entity compare_exchange is
+    Generic(DATA_WIDTH : integer := 16);
+    Port (A : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          B : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          asc : in std_logic;
+          L : out std_logic_vector(DATA_WIDTH-1 downto 0);
+          H : out std_logic_vector(DATA_WIDTH-1 downto 0));
+end compare_exchange;
+
+architecture Behavioral of compare_exchange is
+    signal AgtB, swap : std_logic;
+begin
+    Comparator_Block : entity work.Comparator(Behavioral)
+        Generic Map(DATA_WIDTH => DATA_WIDTH)
+        Port Map(A => A,
+                 B => B,
+                 AgtB => AgtB);
+
+    swap <= AgtB when (asc = '1') else not AgtB;
+    L <= B when (swap = '1') else A;
+    H <= A when (swap = '1') else B;
+
+end Behavioral;
@@ -9,20 +9,47 @@
 -- Tool Versions: Vivado 2023.x / Vitis 2023.x
 ----------------------------------------------------------------------------------
 
+-- S1..S3: selection sort, one comparison per clock:
+--         S1 starts outer iteration i (j = i+1 prefetched on port B),
+--         S2 compares Mj with the running minimum (Emin keeps the smaller
+--         one and its index), S3 swaps the minimum with M[i] (one write
+--         per iteration, skipped when M[i] is already the minimum).
+--         Latency: sum over i = 0..N-2 of (N - i + 1) ~ N^2/2 clocks;
+--         zi ends the sort after K outer iterations when K_REG is set
+--         (i = 0..K-1, ~N K clocks); with N = 1 (zn) s goes straight
+--         to S4
+-- M1..M2: bottom-up merge sort (alg = ALG_MERGE); M1 loads a run pair,
+--         M2 moves one element per clock to the other bank. Latency:
+--         1 + sum over passes of (N + number of run pairs)
+-- R1..R3: LSD radix sort (alg = ALG_RADIX), per digit: R1 counts the
+--         digits, R2 turns the counts into bucket positions, R3 scatters
+--         the elements to the other bank (radix_counters). Latency:
+--         1 + passes * (2 N + 2^RADIX_BITS + 5), whatever the input order;
+--         alg = ALG_SELECT runs the same states, each pass on the
+--         elements left in the bucket of rank K-1
+-- alg = ALG_STREAM sorts while loading (stream_heap), ALG_HIST counts while
+-- loading (hist_unit): s goes straight to S4
+
 library IEEE;
 use IEEE.STD_LOGIC_1164.ALL;
 use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
 
 entity controller is
     Port (clk, s, reset : in std_logic;
-          MigtMj, zi, zj : in std_logic; --signals from datapath
-          Wr, Li, Ei, Lj, Ej, Done : out std_logic
+          alg : in std_logic_vector(2 downto 0); --algorithm select
+          MigtMj, zi, zj, zn : in std_logic; --signals from datapath
+          zk, zlo, zw : in std_logic; --merge status from datapath
+          zc, zb, zp : in std_logic; --radix status from datapath
+          Wr, Li, Ei, Lj, Ej, Emin, Done : out std_logic;
+          Lw, Lp, Em, Enp, Ew : out std_logic; --merge control
+          Lr, Rc, Rp, Rs, Lc, Enr : out std_logic --radix control
           );
 end controller;
 
 architecture Behavioral of controller is
     --Define states for ASM chart
-    type state_type is (S0, S1, S2, S3, S4);
+    type state_type is (S0, S1, S2, S3, S4, M1, M2, R1, R2, R3);
     signal current_state, next_state : state_type;
     
 begin
@@ -36,7 +63,7 @@ begin
     end process;
     
     -- FSM Logic for ASM chart
-    process(current_state, s, MigtMj, zj, zi)
+    process(current_state, s, alg, MigtMj, zj, zi, zn, zk, zlo, zw, zc, zb, zp)
     begin
         next_state <= current_state;
         Done <= '0';
@@ -45,35 +72,57 @@ begin
         Ei <= '0';
         Lj <= '0';
         Ej <= '0';
+        Emin <= '0';
+        Lw <= '0';
+        Lp <= '0';
+        Em <= '0';
+        Enp <= '0';
+        Ew <= '0';
+        Lr <= '0';
+        Rc <= '0';
+        Rp <= '0';
+        Rs <= '0';
+        Lc <= '0';
+        Enr <= '0';
         
         case current_state is
             when S0 =>
                 Li <= '1';
+                Ei <= '1'; --icounter only loads when enabled; restart every sort at i = 0
+                Lw <= '1';
+                Lr <= '1';
                 if (s = '1') then
-                    next_state <= S1;
+                    if (alg = ALG_MERGE) then
+                        next_state <= M1;
+                    elsif (alg = ALG_RADIX or alg = ALG_SELECT) then
+                        next_state <= R1;
+                    elsif (alg = ALG_STREAM or alg = ALG_HIST or zn = '1') then
+                        next_state <= S4;
+                    else
+                        next_state <= S1;
+                    end if;
                 else 
                     next_state <= S0;
                 end if;
-            when S1 =>
+            when S1 => --read M[i] and M[i+1], j = i+2
                 Lj <= '1';
                 Ej <= '1'; --added control signal to properly initialize j counter
                 next_state <= S2;
-            when S2 =>
-                next_state <= S3;
-            when S3 =>
-                if (MigtMj = '1') then
-                    Wr <= '1';
-                end if;
-                if (zj = '0') then
-                    Ej <= '1';
+            when S2 => --compare Mj (M[j-1]) with the minimum, read M[j]
+                Emin <= MigtMj;
+                Ej <= '1';
+                if (zj = '1') then
+                    next_state <= S3;
+                else
                     next_state <= S2;
+                end if;
+            when S3 => --swap the minimum into M[i]
+                Wr <= '1';
+                if (zi = '0') then
+                    Ei <= '1';
+                    next_state <= S1;
                 else
-                    if (zi = '0') then
-                        Ei <= '1';
-                        next_state <= S1;
-                    else
-                        next_state <= S4;
-                    end if;
+                    next_state <= S4;
                 end if;
             when S4 =>
                 Done <= '1';
@@ -82,6 +131,48 @@ begin
                 else
                     next_state <= S4;
                 end if;
+            when M1 => --read the heads of both runs
+                Lp <= '1';
+                next_state <= M2;
+            when M2 => --write the smaller head to the other bank
+                Em <= '1';
+                if (zk = '1') then
+                    if (zlo = '0') then
+                        Enp <= '1';
+                        next_state <= M1;
+                    else
+                        Ew <= '1'; --pass done, swap banks
+                        if (zw = '1') then
+                            next_state <= S4;
+                        else
+                            next_state <= M1;
+                        end if;
+                    end if;
+                end if;
+            when R1 => --count the digits
+                Rc <= '1';
+                if (zc = '1') then
+                    Lc <= '1';
+                    next_state <= R2;
+                end if;
+            when R2 => --prefix sum of the counts
+                Rp <= '1';
+                if (zb = '1') then
+                    Lc <= '1';
+                    next_state <= R3;
+                end if;
+            when R3 => --scatter to the other bank
+                Rs <= '1';
+                if (zc = '1') then
+                    Lc <= '1';
+                    Ew <= '1'; --pass done, swap banks
+                    if (zp = '1') then
+                        next_state <= S4;
+                    else
+                        Enr <= '1';
+                        next_state <= R1;
+                    end if;
+                end if;
             end case;
     end process; 
                                    
@@ -0,0 +1,125 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/09/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: dual_bank_RAM - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Two RAM banks used as ping-pong buffers, plus a host bank for double
+-- buffering (HOST_BANK = true; without it hswap is ignored and the host
+-- ports read zeros, saving one 8K-word bank of BRAM).
+-- Ports A and B (read/write) always address the current bank, port C writes
+-- the other bank and ports HA/HB (read/write) address the host bank.
+-- swap = '1' exchanges the roles of the current and other banks, hswap = '1'
+-- the roles of the current and host banks, on the next rising edge (never
+-- both in the same clock). Outputs follow the bank that had the role when
+-- they were read.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity dual_bank_RAM is
+    Generic(DATA_WIDTH : integer := 16;
+            HOST_BANK : boolean := false); --third bank for double buffering
+    Port(
+    clk   : in  std_logic;
+    swap  : in  std_logic;
+    hswap : in  std_logic;
+    --current bank
+    wea   : in  std_logic;
+    web   : in  std_logic;
+    addra : in  std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    addrb : in  std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    dina  : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    dinb  : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    douta : out std_logic_vector(DATA_WIDTH-1 downto 0);
+    doutb : out std_logic_vector(DATA_WIDTH-1 downto 0);
+    --other bank (write only)
+    wec   : in  std_logic;
+    addrc : in  std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    dinc  : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    --host bank
+    hwea   : in  std_logic;
+    hweb   : in  std_logic;
+    haddra : in  std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    haddrb : in  std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    hdina  : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    hdinb  : in  std_logic_vector(DATA_WIDTH-1 downto 0);
+    hdouta : out std_logic_vector(DATA_WIDTH-1 downto 0);
+    hdoutb : out std_logic_vector(DATA_WIDTH-1 downto 0);
+    --current bank index
+    bank  : out std_logic_vector(1 downto 0)
+    );
+end dual_bank_RAM;
+
+architecture Behavioral of dual_bank_RAM is
+    constant BANKS : integer := 2 + boolean'pos(HOST_BANK);
+    type addr_array is array (0 to 2) of std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    type data_array is array (0 to 2) of std_logic_vector(DATA_WIDTH-1 downto 0);
+    --bank index of each role
+    signal cur, cur_r : unsigned(1 downto 0) := "00";
+    signal oth : unsigned(1 downto 0) := "01";
+    signal hst, hst_r : unsigned(1 downto 0) := "10";
+    signal we_a, we_b : std_logic_vector(0 to 2);
+    signal addr_a, addr_b : addr_array;
+    signal din_a, din_b, dout_a, dout_b : data_array;
+begin
+
+    bank_gen : for b in 0 to BANKS-1 generate
+        bank_ram : entity work.RAM(Behavioral)
+            Generic Map(DATA_WIDTH => DATA_WIDTH)
+            Port Map(clk => clk,
+                     wea => we_a(b),
+                     web => we_b(b),
+                     addra => addr_a(b),
+                     addrb => addr_b(b),
+                     dina => din_a(b),
+                     dinb => din_b(b),
+                     douta => dout_a(b),
+                     doutb => dout_b(b));
+
+        --port A serves A, C or HA depending on the role of the bank
+        we_a(b) <= wea when (cur = b) else
+                   wec when (oth = b) else hwea;
+        addr_a(b) <= addra when (cur = b) else
+                     addrc when (oth = b) else haddra;
+        din_a(b) <= dina when (cur = b) else
+                    dinc when (oth = b) else hdina;
+        --port B serves B or HB (the other bank only reads)
+        we_b(b) <= web when (cur = b) else
+                   hweb when (hst = b) else '0';
+        addr_b(b) <= haddrb when (hst = b) else addrb;
+        din_b(b) <= hdinb when (hst = b) else dinb;
+    end generate;
+    no_host_gen : if not HOST_BANK generate
+        dout_a(2) <= (others => '0');
+        dout_b(2) <= (others => '0');
+    end generate;
+
+    --bank role registers
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            cur_r <= cur;
+            hst_r <= hst;
+            if (swap = '1') then
+                cur <= oth;
+                oth <= cur;
+            elsif (hswap = '1' and HOST_BANK) then
+                cur <= hst;
+                hst <= cur;
+            end if;
+        end if;
+    end process;
+
+    douta <= dout_a(to_integer(cur_r));
+    doutb <= dout_b(to_integer(cur_r));
+    hdouta <= dout_a(to_integer(hst_r));
+    hdoutb <= dout_b(to_integer(hst_r));
+    bank <= std_logic_vector(cur);
+
+end Behavioral;
@@ -0,0 +1,88 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 05/04/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: gen_unit - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Test data generator: fills MEM[0..N-1] through host port A, one element
+-- per clock (one every 4 clocks with slow = '1', the rate of the stream heap).
+-- cfg (GEN_REG write):
+--  bits 1..0  pattern: 0 LFSR, 1 descending (N-1-i), 2 ascending (i),
+--             3 few unique (LFSR and 3: four distinct values)
+--  bit 2      8-bit data (value and 0xFF)
+--  bits 31..16 LFSR seed, 0: 0xACE1
+-- The LFSR is the one of project_main.cpp (16 bits, taps 0, 2, 3, 5, shift
+-- right, element i = state after i+1 steps), so the software can rebuild the
+-- same data set.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity gen_unit is
+    Port (clk, reset : in std_logic;
+          start : in std_logic;
+          cfg : in std_logic_vector(31 downto 0);
+          N : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --0 means 2^13
+          slow : in std_logic;
+          we : out std_logic; --write data to MEM[ri], ri++
+          data : out std_logic_vector(31 downto 0);
+          busy : out std_logic);
+end gen_unit;
+
+architecture Behavioral of gen_unit is
+    signal run : std_logic := '0';
+    signal pat : std_logic_vector(1 downto 0);
+    signal byte : std_logic;
+    signal lfsr, nxt, val : unsigned(15 downto 0);
+    signal i, last : unsigned(MEM_ADDR_WIDTH-1 downto 0);
+    signal div : unsigned(1 downto 0);
+    signal en : std_logic;
+begin
+    last <= unsigned(N) - 1; --N = 0 wraps to 8191
+
+    --next LFSR state, the value of the element
+    nxt <= (lfsr(0) xor lfsr(2) xor lfsr(3) xor lfsr(5)) & lfsr(15 downto 1);
+    with pat select
+        val <= resize(last - i, 16) when "01",
+               resize(i, 16) when "10",
+               nxt and x"0003" when "11",
+               nxt when others;
+    data <= x"0000" & std_logic_vector(val and x"00FF") when (byte = '1') else x"0000" & std_logic_vector(val);
+
+    en <= run when (slow = '0' or div = "11") else '0';
+    we <= en;
+    busy <= run;
+
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            run <= '0';
+        elsif rising_edge(clk) then
+            div <= div + 1;
+            if (start = '1') then
+                run <= '1';
+                pat <= cfg(1 downto 0);
+                byte <= cfg(2);
+                if (unsigned(cfg(31 downto 16)) = 0) then
+                    lfsr <= x"ACE1";
+                else
+                    lfsr <= unsigned(cfg(31 downto 16));
+                end if;
+                i <= (others => '0');
+                div <= (others => '0');
+            elsif (en = '1') then
+                lfsr <= nxt;
+                i <= i + 1;
+                if (i = last) then
+                    run <= '0';
+                end if;
+            end if;
+        end if;
+    end process;
+
+end Behavioral;
@@ -0,0 +1,194 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 04/13/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: hist_unit - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Histogram of the low 8 key bits, counted while the host loads the data,
+-- and the counting sort readback of ALG_HIST.
+--  * load: every key written through the host ports (up to two per clock,
+--    four per MEMW4 access) enters a 4-entry queue; one counter per clock is
+--    read (port A) and written back incremented (port B). A key equal to the
+--    one written on the same edge takes the forwarded count.
+--  * clr (init_write) empties the histogram at once: a 256-bit map marks the
+--    buckets counted since clr, the others read as 0
+--  * start (init_read) walks the buckets in ascending order; top is the
+--    current key, pop (MEMR_ri) moves to the next element. The next
+--    non-empty bucket is found by a priority encoder over the map, so
+--    top is valid 2 clocks after start or pop.
+--  * count is the histogram entry of bucket hidx, one clock after hidx
+-- Host accesses must be at least HOST_GAP clocks apart (chu_sorting_core).
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity hist_unit is
+    Port (clk : in std_logic;
+          clr : in std_logic; --start a new data set
+          --keys written by the host ports (pack_unit)
+          WeA, WeB : in std_logic;
+          KeyA, KeyB : in std_logic_vector(7 downto 0);
+          --sorted readback
+          start, pop : in std_logic;
+          top : out std_logic_vector(7 downto 0);
+          --histogram readback
+          hidx : in std_logic_vector(7 downto 0);
+          count : out std_logic_vector(MEM_ADDR_WIDTH downto 0)); --0 .. 8192
+end hist_unit;
+
+architecture Behavioral of hist_unit is
+    constant CW : integer := MEM_ADDR_WIDTH + 1; --counter width
+    type key_array is array (0 to 3) of std_logic_vector(7 downto 0);
+    type emit_state is (E_IDLE, E_SEEK, E_LOAD, E_READY);
+    signal q : key_array;
+    signal qn : integer range 0 to 4 := 0;
+    signal k1, k2 : std_logic_vector(7 downto 0); --keys in the write stage, last written
+    signal v1, v2 : std_logic := '0';
+    signal c2 : unsigned(CW-1 downto 0); --last written count
+    signal cnt, newc : unsigned(CW-1 downto 0);
+    signal map_r : std_logic_vector(255 downto 0) := (others => '0');
+    signal AddrA, AddrB : std_logic_vector(7 downto 0);
+    signal douta, doutb, dinb : std_logic_vector(CW-1 downto 0);
+    signal zero : std_logic_vector(CW-1 downto 0) := (others => '0'); --port A never writes
+    signal hidx_r : std_logic_vector(7 downto 0);
+    signal est : emit_state := E_IDLE;
+    signal from : unsigned(8 downto 0); --first bucket of the next seek
+    signal nb : unsigned(7 downto 0); --next non-empty bucket
+    signal nf : std_logic;
+    signal cur_b : unsigned(7 downto 0);
+    signal cur_r : unsigned(CW-1 downto 0);
+begin
+
+    counter_ram : entity work.RAM(Behavioral)
+        Generic Map(ADDR_WIDTH => 8,
+                    DATA_WIDTH => CW)
+        Port Map(clk => clk,
+                 wea => '0',
+                 web => v1,
+                 addra => AddrA,
+                 addrb => AddrB,
+                 dina => zero,
+                 dinb => dinb,
+                 douta => douta,
+                 doutb => doutb);
+
+    --port A: read stage of the counter (load) or next bucket (readback)
+    AddrA <= q(0) when (qn > 0) else std_logic_vector(nb);
+    --port B: write stage of the counter or histogram readback
+    AddrB <= k1 when (v1 = '1') else hidx;
+
+    --write stage: forwarded, counted or empty bucket
+    cnt <= c2 when (v2 = '1' and k2 = k1) else
+           unsigned(douta) when (map_r(to_integer(unsigned(k1))) = '1') else (others => '0');
+    newc <= cnt + 1;
+    dinb <= std_logic_vector(newc);
+
+    --key queue and counter pipeline
+    process(clk)
+        variable qq : key_array;
+        variable n : integer range 0 to 4;
+    begin
+        if rising_edge(clk) then
+            qq := q;
+            n := qn;
+            --read stage: oldest key
+            if (n > 0) then
+                k1 <= qq(0);
+                v1 <= '1';
+                qq(0 to 2) := qq(1 to 3);
+                n := n - 1;
+            else
+                v1 <= '0';
+            end if;
+            if (WeA = '1' and n < 4) then
+                qq(n) := KeyA;
+                n := n + 1;
+            end if;
+            if (WeB = '1' and n < 4) then
+                qq(n) := KeyB;
+                n := n + 1;
+            end if;
+            --write stage
+            k2 <= k1;
+            c2 <= newc;
+            v2 <= v1;
+            if (v1 = '1') then
+                map_r(to_integer(unsigned(k1))) <= '1';
+            end if;
+            if (clr = '1') then
+                n := 0;
+                v1 <= '0';
+                v2 <= '0';
+                map_r <= (others => '0');
+            end if;
+            q <= qq;
+            qn <= n;
+            hidx_r <= hidx;
+        end if;
+    end process;
+
+    count <= doutb when (map_r(to_integer(unsigned(hidx_r))) = '1') else (others => '0');
+
+    --priority encoder: lowest counted bucket >= from
+    process(map_r, from)
+        variable f : std_logic;
+        variable b : integer range 0 to 255;
+    begin
+        f := '0';
+        b := 0;
+        for i in 255 downto 0 loop
+            if (map_r(i) = '1' and i >= to_integer(from)) then
+                f := '1';
+                b := i;
+            end if;
+        end loop;
+        nf <= f;
+        nb <= to_unsigned(b, 8);
+    end process;
+
+    --sorted readback: bucket cur_b, cur_r elements left
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            case est is
+                when E_IDLE =>
+                    null;
+                when E_SEEK => --port A reads the count of bucket nb
+                    if (nf = '1') then
+                        cur_b <= nb;
+                        est <= E_LOAD;
+                    else
+                        est <= E_IDLE;
+                    end if;
+                when E_LOAD =>
+                    cur_r <= unsigned(douta);
+                    est <= E_READY;
+                when E_READY =>
+                    if (pop = '1') then
+                        if (cur_r > 1) then
+                            cur_r <= cur_r - 1;
+                        elsif (cur_b = 255) then
+                            est <= E_IDLE;
+                        else
+                            from <= resize(cur_b, 9) + 1;
+                            est <= E_SEEK;
+                        end if;
+                    end if;
+            end case;
+            if (start = '1') then
+                from <= (others => '0');
+                est <= E_SEEK;
+            end if;
+            if (clr = '1') then
+                est <= E_IDLE;
+            end if;
+        end if;
+    end process;
+    top <= std_logic_vector(cur_b);
+
+end Behavioral;
@@ -17,17 +17,23 @@ use IEEE.NUMERIC_STD.ALL;
 --library UNISIM;
 --use UNISIM.VComponents.all;
 
+-- Outer loop of the selection sort. zi marks the last outer iteration:
+-- i = N-2 for a full sort, i = K-1 for a partial sort (0 < K < N-1), after
+-- which M[0..K-1] holds the K smallest elements in order. zn marks N = 1
+-- (N = 0 stands for 8192): no outer iteration, the sort ends at once.
 entity icounter is
     Port(clk, en, ld : in std_logic;
          N : in std_logic_vector(12 downto 0);
+         K : in std_logic_vector(12 downto 0); --0: full sort
          Q : out std_logic_vector(12 downto 0);
-         zi : out std_logic
+         zi, zn : out std_logic
          );
 end icounter;
 
 architecture Behavioral of icounter is
     
     signal count : unsigned(12 downto 0) := (OTHERS => '0');
+    signal last : unsigned(12 downto 0);
     
 begin
     process(clk) 
@@ -44,5 +50,7 @@ begin
     end process;
 
     Q <= std_logic_vector(count);
-    zi <= '1' when count = (unsigned(N) - 2) else '0'; -- zi = '1' when i loop finished 
+    last <= unsigned(K) - 1 when (unsigned(K) /= 0 and unsigned(K) < unsigned(N) - 1) else unsigned(N) - 2;
+    zi <= '1' when count = last else '0'; -- zi = '1' when i loop finished 
+    zn <= '1' when unsigned(N) = 1 else '0'; -- nothing to sort, N-2 would wrap
 end Behavioral;
\ No newline at end of file
@@ -0,0 +1,100 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/09/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: merge_counters - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Run pointers of the bottom-up merge sort.
+-- A pass with run width w merges the runs [lo, mid) and [mid, hi) of the
+-- current bank into [lo, hi) of the other bank, lo = 0, 2w, 4w, ...
+-- The RAM is addressed with the next pointer values (inext, jnext) so the
+-- heads of both runs are on Mi/Mj in every merge clock.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity merge_counters is
+    Port(clk : in std_logic;
+         N : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --0 means 2^13
+         MigtMj : in std_logic;
+         --control signals from the controller
+         Lw : in std_logic; --first pass: w = 1, lo = 0
+         Lp : in std_logic; --load run pair at lo
+         Em : in std_logic; --move one element to the other bank
+         Enp : in std_logic; --next run pair: lo = lo + 2w
+         Ew : in std_logic; --next pass: w = 2w, lo = 0
+         --RAM addresses
+         inext, jnext, k : out std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+         take : out std_logic; --'1': Mi is the next output, '0': Mj
+         --status to the controller
+         zk, zlo, zw : out std_logic --last element of pair, last pair, last pass
+         );
+end merge_counters;
+
+architecture Behavioral of merge_counters is
+    --one extra bit: pointers and bounds reach 2^13
+    signal n_eff, w, lo, i, j, kc, mid, hi : unsigned(MEM_ADDR_WIDTH downto 0) := (others => '0');
+    signal mid_c, hi_c, lo2w : unsigned(MEM_ADDR_WIDTH downto 0);
+    signal t : std_logic;
+begin
+    n_eff <= to_unsigned(2**MEM_ADDR_WIDTH, MEM_ADDR_WIDTH + 1) when unsigned(N) = 0
+             else resize(unsigned(N), MEM_ADDR_WIDTH + 1);
+
+    --bounds of the run pair starting at lo
+    lo2w <= lo + shift_left(w, 1);
+    mid_c <= lo + w when (lo + w < n_eff) else n_eff;
+    hi_c <= lo2w when (lo2w < n_eff) else n_eff;
+
+    --take the left head while the left run lasts and it is not greater (stable)
+    t <= '1' when (i < mid) and ((j >= hi) or (MigtMj = '0')) else '0';
+    take <= t;
+
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            if (Lw = '1') then
+                w <= to_unsigned(1, MEM_ADDR_WIDTH + 1);
+                lo <= (others => '0');
+            elsif (Ew = '1') then
+                w <= shift_left(w, 1);
+                lo <= (others => '0');
+            elsif (Enp = '1') then
+                lo <= lo2w;
+            end if;
+
+            if (Lp = '1') then
+                i <= lo;
+                j <= mid_c;
+                kc <= lo;
+                mid <= mid_c;
+                hi <= hi_c;
+            elsif (Em = '1') then
+                kc <= kc + 1;
+                if (t = '1') then
+                    i <= i + 1;
+                else
+                    j <= j + 1;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    --next pointer values address the RAM
+    inext <= std_logic_vector(lo(MEM_ADDR_WIDTH-1 downto 0)) when (Lp = '1') else
+             std_logic_vector(i(MEM_ADDR_WIDTH-1 downto 0) + 1) when (Em = '1' and t = '1') else
+             std_logic_vector(i(MEM_ADDR_WIDTH-1 downto 0));
+    jnext <= std_logic_vector(mid_c(MEM_ADDR_WIDTH-1 downto 0)) when (Lp = '1') else
+             std_logic_vector(j(MEM_ADDR_WIDTH-1 downto 0) + 1) when (Em = '1' and t = '0') else
+             std_logic_vector(j(MEM_ADDR_WIDTH-1 downto 0));
+    k <= std_logic_vector(kc(MEM_ADDR_WIDTH-1 downto 0));
+
+    zk <= '1' when kc + 1 = hi else '0';
+    zlo <= '1' when lo2w >= n_eff else '0';
+    zw <= '1' when shift_left(w, 1) >= n_eff else '0';
+
+end Behavioral;
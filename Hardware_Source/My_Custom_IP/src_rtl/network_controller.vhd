@@ -0,0 +1,148 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/02/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: network_controller - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Pass sequencer of the bitonic sorting network (see Network_datapath).
+-- For a network of size 2^lgN the passes are
+--   for lgk in 1..lgN, for lgj in lgk-1 downto 0: one pass over all row pairs
+-- Each row pair takes two clocks: S1 reads both rows, S2 compare-exchanges
+-- and writes them back in place. Latency from s=1 to Done:
+--   1 + 2 * (lgN*(lgN+1)/2) * max(1, 2^lgN / (2*LANES))
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity network_controller is
+    Generic(LANES : integer := 16);
+    Port (clk, s, reset : in std_logic;
+          N_in : in std_logic_vector(15 downto 0);
+          --pass and row pair counters to the datapath
+          lgk, lgj : out std_logic_vector(3 downto 0); --block size 2^lgk, partner distance 2^lgj
+          p : out std_logic_vector(11 downto 0); --row pair index within the pass
+          First : out std_logic; --first pass: pad elements N..2^lgN-1 with all ones
+          Wb, Done : out std_logic
+          );
+end network_controller;
+
+architecture Behavioral of network_controller is
+    constant LG_LANES : integer := log2c(LANES);
+    type state_type is (S0, S1, S2, S3);
+    signal current_state, next_state : state_type;
+    signal lgN : unsigned(3 downto 0);
+    signal p_last : unsigned(11 downto 0);
+    signal lgk_r, lgj_r : unsigned(3 downto 0);
+    signal p_r : unsigned(11 downto 0);
+    signal Lc, Ep, Ej, Ek : std_logic; --load counters, next row pair, next j, next k
+    signal zp, zj, zk : std_logic;
+begin
+    --lgN = ceil(log2(N)); N = 0 means 8192 as for the selection datapath
+    process(N_in)
+        variable nm1 : unsigned(12 downto 0);
+    begin
+        nm1 := unsigned(N_in(12 downto 0)) - 1;
+        lgN <= (others => '0');
+        for b in 0 to 12 loop
+            if nm1(b) = '1' then
+                lgN <= to_unsigned(b + 1, 4);
+            end if;
+        end loop;
+    end process;
+
+    --row pairs per pass = 2^lgN / (2*LANES), at least one
+    p_last <= shift_left(to_unsigned(1, 12), to_integer(lgN) - LG_LANES - 1) - 1
+              when to_integer(lgN) > LG_LANES else (others => '0');
+
+    zp <= '1' when p_r = p_last else '0';
+    zj <= '1' when lgj_r = 0 else '0';
+    zk <= '1' when lgk_r = lgN else '0';
+
+    --counters
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            if (Lc = '1') then
+                lgk_r <= to_unsigned(1, 4);
+                lgj_r <= (others => '0');
+                p_r <= (others => '0');
+            elsif (Ep = '1') then
+                if (zp = '1') then
+                    p_r <= (others => '0');
+                    if (Ek = '1') then
+                        lgk_r <= lgk_r + 1;
+                        lgj_r <= lgk_r; --new lgk - 1
+                    elsif (Ej = '1') then
+                        lgj_r <= lgj_r - 1;
+                    end if;
+                else
+                    p_r <= p_r + 1;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    lgk <= std_logic_vector(lgk_r);
+    lgj <= std_logic_vector(lgj_r);
+    p <= std_logic_vector(p_r);
+    First <= '1' when lgk_r = 1 else '0';
+
+    process(clk, reset)
+    begin
+        if (reset = '1') then
+            current_state <= S0;
+        elsif rising_edge(clk) then
+            current_state <= next_state;
+        end if;
+    end process;
+
+    -- FSM Logic
+    process(current_state, s, lgN, zp, zj, zk)
+    begin
+        next_state <= current_state;
+        Done <= '0';
+        Wb <= '0';
+        Lc <= '0';
+        Ep <= '0';
+        Ej <= '0';
+        Ek <= '0';
+
+        case current_state is
+            when S0 =>
+                Lc <= '1';
+                if (s = '1') then
+                    if (lgN = 0) then
+                        next_state <= S3; --nothing to sort
+                    else
+                        next_state <= S1;
+                    end if;
+                end if;
+            when S1 => --BRAM read of both rows
+                next_state <= S2;
+            when S2 => --compare-exchange and write back
+                Wb <= '1';
+                Ep <= '1';
+                next_state <= S1;
+                if (zp = '1') then
+                    if (zj = '0') then
+                        Ej <= '1';
+                    elsif (zk = '0') then
+                        Ek <= '1';
+                    else
+                        next_state <= S3;
+                    end if;
+                end if;
+            when S3 =>
+                Done <= '1';
+                if (s = '0') then
+                    next_state <= S0;
+                end if;
+        end case;
+    end process;
+
+end Behavioral;
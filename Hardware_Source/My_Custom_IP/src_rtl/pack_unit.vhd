@@ -0,0 +1,127 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/23/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: pack_unit - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Host side of the sorting memory: drives both RAM ports while s = '0' so
+-- one bus word can carry several elements.
+--  * W1: one element       -> port A at ri
+--  * W2: two 16-bit elements -> ports A/B at ri, ri+1
+--  * W4: four 8-bit elements -> ports A/B at ri, ri+1, then ri+2, ri+3 on
+--        the next clock (pending write)
+--  * WW/WR: memory window, port A at WA; the RAM output (DoutA) holds
+--        MEM[WA] on the next clock
+-- Reads are served from a 4-element buffer refreshed while idle: the ports
+-- alternate between (ri, ri+1) and (ri+2, ri+3) each clock, so the buffer
+-- holds MEM[ri .. ri+3] three clocks after ri changes. Host accesses must be
+-- at least HOST_GAP clocks apart, chu_sorting_core holds a closer one.
+-- W1 writes a key of up to 32 bits, W2/W4 16/8-bit keys. With INDEX the
+-- address of each element is stored in its index field.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity pack_unit is
+    Generic(KEY_WIDTH : integer := 16; --up to 32
+            INDEX : boolean := false);
+    Port (clk : in std_logic;
+          ri : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+          W1, W2, W4 : in std_logic; --write strobes (init write mode)
+          wr_data : in std_logic_vector(31 downto 0);
+          WA : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --memory window address
+          WW, WR : in std_logic; --memory window write/read
+          --host ports of the datapath
+          AddrA, AddrB : out std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+          DinA, DinB : out std_logic_vector(word_width(KEY_WIDTH, INDEX)-1 downto 0);
+          WeA, WeB : out std_logic;
+          DoutA, DoutB : in std_logic_vector(word_width(KEY_WIDTH, INDEX)-1 downto 0);
+          --read data
+          Rd1 : out std_logic_vector(31 downto 0); --key of MEM[ri]
+          RdX : out std_logic_vector(IDX_WIDTH-1 downto 0); --index of MEM[ri]
+          Rd2 : out std_logic_vector(31 downto 0); --MEM[ri+1] & MEM[ri] (16-bit keys)
+          Rd4 : out std_logic_vector(31 downto 0)); --low bytes of the keys of MEM[ri+3] .. MEM[ri]
+end pack_unit;
+
+architecture Behavioral of pack_unit is
+    constant DW : integer := word_width(KEY_WIDTH, INDEX);
+    type buf_array is array (0 to 3) of std_logic_vector(DW-1 downto 0);
+    type key_array is array (0 to 3) of std_logic_vector(31 downto 0);
+    signal rbuf : buf_array := (others => (others => '0'));
+    signal rkey : key_array;
+    signal pend, phase, rd_phase, rd_valid : std_logic := '0';
+    signal pend_addr : unsigned(MEM_ADDR_WIDTH-1 downto 0);
+    signal pend_d2, pend_d3 : std_logic_vector(7 downto 0);
+    signal base, a : unsigned(MEM_ADDR_WIDTH-1 downto 0);
+    signal wr_any : std_logic;
+    signal keyA, keyB : std_logic_vector(31 downto 0);
+begin
+    wr_any <= W1 or W2 or W4 or WW;
+
+    --port addresses: host write, pending bytes or read-ahead
+    base <= unsigned(ri) + 2 when (phase = '1') else unsigned(ri);
+    a <= pend_addr when (pend = '1') else
+         unsigned(WA) when (WW = '1' or WR = '1') else
+         unsigned(ri) when (wr_any = '1') else base;
+    AddrA <= std_logic_vector(a);
+    AddrB <= std_logic_vector(a + 1);
+
+    keyA <= x"000000" & pend_d2 when (pend = '1') else
+            x"000000" & wr_data(7 downto 0) when (W4 = '1') else
+            x"0000" & wr_data(15 downto 0) when (W2 = '1') else wr_data;
+    keyB <= x"000000" & pend_d3 when (pend = '1') else
+            x"000000" & wr_data(15 downto 8) when (W4 = '1') else x"0000" & wr_data(31 downto 16);
+
+    --element words: key, then the element address as index
+    idx_gen : if INDEX generate
+        DinA <= keyA(KEY_WIDTH-1 downto 0) & std_logic_vector(a);
+        DinB <= keyB(KEY_WIDTH-1 downto 0) & std_logic_vector(a + 1);
+    end generate;
+    key_gen : if not INDEX generate
+        DinA <= keyA(KEY_WIDTH-1 downto 0);
+        DinB <= keyB(KEY_WIDTH-1 downto 0);
+    end generate;
+    WeA <= wr_any or pend;
+    WeB <= W2 or W4 or pend;
+
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            --upper bytes of a W4 write go out on the next clock
+            pend <= W4;
+            if (W4 = '1') then
+                pend_addr <= unsigned(ri) + 2;
+                pend_d2 <= wr_data(23 downto 16);
+                pend_d3 <= wr_data(31 downto 24);
+            end if;
+
+            --read-ahead buffer (RAM outputs are one clock behind the address)
+            phase <= not phase;
+            rd_phase <= phase;
+            rd_valid <= not (wr_any or pend or WR);
+            if (rd_valid = '1') then
+                if (rd_phase = '0') then
+                    rbuf(0) <= DoutA;
+                    rbuf(1) <= DoutB;
+                else
+                    rbuf(2) <= DoutA;
+                    rbuf(3) <= DoutB;
+                end if;
+            end if;
+        end if;
+    end process;
+
+    key_out : for i in 0 to 3 generate
+        rkey(i) <= key_of(rbuf(i), KEY_WIDTH);
+    end generate;
+    Rd1 <= rkey(0);
+    RdX <= index_of(rbuf(0), INDEX);
+    Rd2 <= rkey(1)(15 downto 0) & rkey(0)(15 downto 0);
+    Rd4 <= rkey(3)(7 downto 0) & rkey(2)(7 downto 0) & rkey(1)(7 downto 0) & rkey(0)(7 downto 0);
+
+end Behavioral;
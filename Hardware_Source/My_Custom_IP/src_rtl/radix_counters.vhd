@@ -0,0 +1,208 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 04/20/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: radix_counters - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Bucket counters and element pointer of the LSD radix sort (ALG_RADIX).
+-- Pass p sorts on digit p, key bits p*RADIX_BITS .. (p+1)*RADIX_BITS-1, from
+-- the current bank into the other bank (stable, so equal keys keep their
+-- order); ceil(KEY_WIDTH / RADIX_BITS) passes in total. Every pass has three
+-- phases driven by the controller, c counts the clocks of a phase:
+--  * Rc: count. M[c] is read on port A of the current bank, its digit
+--        addresses the counter RAM one clock later and the incremented count
+--        is written back the clock after (N + 2 clocks)
+--  * Rp: prefix sum. Counter b is replaced by the number of elements with a
+--        smaller digit (2^RADIX_BITS + 1 clocks)
+--  * Rs: scatter. Like Rc, but M[c] is written to the other bank at the
+--        position held by the counter of its digit, which is incremented
+--        (N + 2 clocks)
+-- A digit equal to the one written on the same clock edge takes the
+-- forwarded counter. A 2^RADIX_BITS-bit map marks the counters written
+-- during the count phase, so the counters need no clearing.
+-- Latency per pass: 2 N + 2^RADIX_BITS + 5 clocks.
+-- sel = '1' (ALG_SELECT): selection of rank K-1 (0 < K <= N, else N-1),
+-- digits from the most significant one. The prefix sum finds the bucket
+-- holding the rank and the scatter keeps only its elements, packed at their
+-- final sorted positions g .. g+m-1, so the next pass reads m elements
+-- (m = N on the first pass, typically N / 2^RADIX_BITS on the second).
+-- After the last pass MEM[K-1] holds the K-th smallest element, as after a
+-- full sort; the rest of the memory is unspecified.
+-- Latency: 1 + sum over passes of (2 m + 2^RADIX_BITS + 5) clocks.
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity radix_counters is
+    Generic(DATA_WIDTH : integer := 16; --element word (key and index)
+            KEY_WIDTH : integer := 16;
+            RADIX_BITS : integer := 8); --digit width, 1..8
+    Port(clk : in std_logic;
+         N : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --0 means 2^13
+         K : in std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --ALG_SELECT: rank K-1
+         sel : in std_logic; --ALG_SELECT
+         Mi : in std_logic_vector(DATA_WIDTH-1 downto 0); --port A of the current bank
+         --control signals from the controller
+         Lr : in std_logic; --first pass
+         Rc, Rp, Rs : in std_logic; --count, prefix sum, scatter phase
+         Lc : in std_logic; --last clock of a phase: c = 0
+         Enr : in std_logic; --next pass
+         --RAM addresses
+         c_addr : out std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --element read on port A
+         k : out std_logic_vector(MEM_ADDR_WIDTH-1 downto 0); --other bank (port C)
+         kdata : out std_logic_vector(DATA_WIDTH-1 downto 0);
+         kwe : out std_logic;
+         --status to the controller
+         zc, zb, zp : out std_logic --last clock of count/scatter, of prefix sum, last pass
+         );
+end radix_counters;
+
+architecture Behavioral of radix_counters is
+    constant PASSES : integer := (KEY_WIDTH + RADIX_BITS - 1) / RADIX_BITS;
+    constant BUCKETS : integer := 2**RADIX_BITS;
+    constant CW : integer := MEM_ADDR_WIDTH + 1; --counts and positions reach 2^13
+    signal n_eff, c : unsigned(MEM_ADDR_WIDTH + 1 downto 0) := (others => '0');
+    signal m, g, kk : unsigned(MEM_ADDR_WIDTH + 1 downto 0); --elements, first position, rank in them
+    signal pass, pos : integer range 0 to PASSES - 1 := 0;
+    signal dg, d2, d3, b1 : std_logic_vector(RADIX_BITS-1 downto 0);
+    signal v1, v2, v3, pv1 : std_logic := '0';
+    signal e2 : std_logic_vector(DATA_WIDTH-1 downto 0);
+    signal c3, acc, cur, cnt : unsigned(CW-1 downto 0);
+    signal sel_b : std_logic_vector(RADIX_BITS-1 downto 0); --bucket of the rank
+    signal sel_base, sel_cnt, wp : unsigned(CW-1 downto 0);
+    signal keep : std_logic;
+    signal map_r : std_logic_vector(BUCKETS-1 downto 0) := (others => '0');
+    signal AddrA, AddrB : std_logic_vector(RADIX_BITS-1 downto 0);
+    signal douta, dinb : std_logic_vector(CW-1 downto 0);
+    signal zero : std_logic_vector(CW-1 downto 0) := (others => '0'); --port A never writes
+    signal web : std_logic;
+begin
+    n_eff <= to_unsigned(2**MEM_ADDR_WIDTH, MEM_ADDR_WIDTH + 2) when unsigned(N) = 0
+             else resize(unsigned(N), MEM_ADDR_WIDTH + 2);
+
+    counter_ram : entity work.RAM(Behavioral)
+        Generic Map(ADDR_WIDTH => RADIX_BITS,
+                    DATA_WIDTH => CW)
+        Port Map(clk => clk,
+                 wea => '0',
+                 web => web,
+                 addra => AddrA,
+                 addrb => AddrB,
+                 dina => zero,
+                 dinb => dinb,
+                 douta => douta,
+                 doutb => open);
+
+    --digit of the element on Mi (most significant first for ALG_SELECT)
+    pos <= PASSES - 1 - pass when (sel = '1') else pass;
+    process(Mi, pos)
+        variable key : unsigned(31 downto 0);
+    begin
+        key := unsigned(key_of(Mi, KEY_WIDTH));
+        dg <= std_logic_vector(resize(shift_right(key, pos * RADIX_BITS), RADIX_BITS));
+    end process;
+
+    --port A: counter of the next digit or bucket c of the prefix sum
+    AddrA <= std_logic_vector(c(RADIX_BITS-1 downto 0)) when (Rp = '1') else dg;
+
+    --write stage: forwarded, counted or (count phase) untouched counter
+    cnt <= unsigned(douta) when (map_r(to_integer(unsigned(b1))) = '1') else (others => '0');
+    cur <= c3 when (v3 = '1' and d3 = d2) else
+           (others => '0') when (Rc = '1' and map_r(to_integer(unsigned(d2))) = '0') else
+           unsigned(douta);
+    AddrB <= b1 when (pv1 = '1') else d2;
+    dinb <= std_logic_vector(acc) when (pv1 = '1') else std_logic_vector(cur + 1);
+    web <= pv1 or v2;
+
+    process(clk)
+    begin
+        if rising_edge(clk) then
+            --phase clock counter and pass
+            if (Lr = '1' or Lc = '1') then
+                c <= (others => '0');
+            elsif (Rc = '1' or Rp = '1' or Rs = '1') then
+                c <= c + 1;
+            end if;
+            if (Lr = '1') then
+                pass <= 0;
+            elsif (Enr = '1') then
+                pass <= pass + 1;
+            end if;
+
+            --count/scatter pipeline
+            if ((Rc = '1' or Rs = '1') and c < m) then
+                v1 <= '1';
+            else
+                v1 <= '0';
+            end if;
+            v2 <= v1;
+            d2 <= dg;
+            e2 <= Mi;
+            v3 <= v2;
+            d3 <= d2;
+            c3 <= cur + 1;
+
+            --prefix sum pipeline
+            if (Rp = '1' and c < BUCKETS) then
+                pv1 <= '1';
+            else
+                pv1 <= '0';
+            end if;
+            b1 <= std_logic_vector(c(RADIX_BITS-1 downto 0));
+            if (Rc = '1') then
+                acc <= (others => '0');
+            elsif (pv1 = '1') then
+                acc <= acc + cnt;
+            end if;
+
+            --ALG_SELECT: bucket of the rank, kept elements and next range
+            if (pv1 = '1' and kk >= acc and kk < resize(acc + cnt, kk'length)) then
+                sel_b <= b1;
+                sel_base <= acc;
+                sel_cnt <= cnt;
+            end if;
+            if (Rp = '1') then
+                wp <= (others => '0');
+            elsif (keep = '1') then
+                wp <= wp + 1;
+            end if;
+            if (Lr = '1') then
+                m <= n_eff;
+                g <= (others => '0');
+                if (unsigned(K) = 0 or unsigned(K) > n_eff) then
+                    kk <= n_eff - 1;
+                else
+                    kk <= resize(unsigned(K), kk'length) - 1;
+                end if;
+            elsif (Enr = '1' and sel = '1') then
+                m <= resize(sel_cnt, m'length);
+                g <= g + sel_base;
+                kk <= kk - sel_base;
+            end if;
+
+            --counters written since the count phase started
+            if (Lr = '1' or Enr = '1') then
+                map_r <= (others => '0');
+            elsif (Rc = '1' and v2 = '1') then
+                map_r(to_integer(unsigned(d2))) <= '1';
+            end if;
+        end if;
+    end process;
+
+    c_addr <= std_logic_vector(resize(g + c, MEM_ADDR_WIDTH));
+    keep <= Rs and v2 and sel when (d2 = sel_b) else '0';
+    k <= std_logic_vector(resize(g + sel_base + wp, MEM_ADDR_WIDTH)) when (sel = '1') else
+         std_logic_vector(cur(MEM_ADDR_WIDTH-1 downto 0));
+    kdata <= e2;
+    kwe <= keep when (sel = '1') else Rs and v2;
+
+    zc <= '1' when c = m + 1 else '0';
+    zb <= '1' when c = BUCKETS else '0';
+    zp <= '1' when pass = PASSES - 1 else '0';
+
+end Behavioral;
@@ -0,0 +1,95 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/02/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: sort_core_pkg
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Shared constants and helper functions of the sorting core entities
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+
+package sort_core_pkg is
+    constant MEM_ADDR_WIDTH : integer := 13; -- 2^13 = 8192 elements
+    -- clocks from one host access of the core to the next (pack_unit read-ahead,
+    -- stream_heap, hist_unit); chu_sorting_core holds a closer access (ready)
+    constant HOST_GAP : integer := 4;
+
+    -- algorithm select field, CTRL_REG bits 5..3
+    constant ALG_SELECTION : std_logic_vector(2 downto 0) := "000"; -- ~N^2/2 clocks
+    constant ALG_MERGE     : std_logic_vector(2 downto 0) := "001"; -- ~N log2 N clocks
+    constant ALG_STREAM    : std_logic_vector(2 downto 0) := "010"; -- heap fed by MMIO, no sort phase
+    constant ALG_HIST      : std_logic_vector(2 downto 0) := "011"; -- counting sort of 8-bit keys, no sort phase
+    constant ALG_RADIX     : std_logic_vector(2 downto 0) := "100"; -- LSD radix sort, ~2 N clocks per digit
+    constant ALG_SELECT    : std_logic_vector(2 downto 0) := "101"; -- MSD radix select of rank K-1, ~2 N clocks
+
+    -- element word: key (KEY_WIDTH bits) followed by the optional index
+    -- field (position of the element when it was loaded, IDX_WIDTH bits);
+    -- words are compared as a whole, so equal keys keep their load order
+    constant IDX_WIDTH : integer := MEM_ADDR_WIDTH;
+
+    -- ceiling of log2(n); used to size lane/bank select fields
+    function log2c(n : integer) return integer;
+    -- width of the element word
+    function word_width(key_width : integer; index : boolean) return integer;
+    -- key (zero-extended to 32 bits) and index fields of an element word
+    function key_of(w : std_logic_vector; key_width : integer) return std_logic_vector;
+    function index_of(w : std_logic_vector; index : boolean) return std_logic_vector;
+    -- estimated RAMB36 of the core: copies 8K x dw memories (8K x 4 per RAMB36),
+    -- the stream_heap levels 9..12 when heap (dw+1 bits; smaller levels not
+    -- counted) and the 256-entry counter RAMs
+    function bram36_estimate(dw, copies : integer; heap : boolean) return integer;
+end sort_core_pkg;
+
+package body sort_core_pkg is
+    function log2c(n : integer) return integer is
+        variable m, p : integer;
+    begin
+        m := 0;
+        p := 1;
+        while p < n loop
+            m := m + 1;
+            p := p * 2;
+        end loop;
+        return m;
+    end log2c;
+
+    function word_width(key_width : integer; index : boolean) return integer is
+    begin
+        if index then
+            return key_width + IDX_WIDTH;
+        end if;
+        return key_width;
+    end word_width;
+
+    function key_of(w : std_logic_vector; key_width : integer) return std_logic_vector is
+        variable k : std_logic_vector(key_width-1 downto 0);
+    begin
+        k := w(w'high downto w'high - key_width + 1);
+        return std_logic_vector(resize(unsigned(k), 32));
+    end key_of;
+
+    function index_of(w : std_logic_vector; index : boolean) return std_logic_vector is
+        variable x : std_logic_vector(IDX_WIDTH-1 downto 0);
+    begin
+        x := (others => '0');
+        if index then
+            x := w(w'low + IDX_WIDTH - 1 downto w'low);
+        end if;
+        return x;
+    end index_of;
+
+    function bram36_estimate(dw, copies : integer; heap : boolean) return integer is
+        variable n : integer;
+    begin
+        n := copies * ((dw + 3) / 4) + 1;
+        if heap then
+            n := n + (dw + 9) / 9 + (dw + 18) / 18 + (dw + 36) / 36; --4K x 9, 2K x 18, 2 x RAMB18
+        end if;
+        return n;
+    end bram36_estimate;
+end sort_core_pkg;
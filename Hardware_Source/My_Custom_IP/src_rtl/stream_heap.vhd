@@ -0,0 +1,262 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 03/16/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: stream_heap - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / Vitis 2023.x
+----------------------------------------------------------------------------------
+-- Pipelined min-heap for the streaming mode (alg = ALG_STREAM).
+-- Every host write (push) inserts one element, every host read (pop) returns
+-- the smallest element and removes it, so the data is sorted while it is
+-- loaded and readback starts right after the last write.
+--
+-- Level l of the heap (positions 2^l .. 2^(l+1)-1) has its own RAM and its
+-- own pipeline stage; level 0 (the smallest element) is the register top.
+-- An operation (token) spends two clocks per stage, read then write, and
+-- moves down one level, so several tokens are in flight at a time:
+--  * push: top-down insertion towards position count+1, the smaller value
+--    stays at each level and the larger one moves down
+--  * pop : the hole left by the smallest element sinks down, filled by the
+--    smaller child; nodes past the loaded count read as empty (bit
+--    DATA_WIDTH)
+-- Consecutive host accesses must be at least HOST_GAP (4) clocks apart;
+-- chu_sorting_core holds a closer access on the bus (ready).
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity stream_heap is
+    Generic(DATA_WIDTH : integer := 16); --element word (key and index)
+    Port (clk : in std_logic;
+          clr : in std_logic; --start a new data set (count = 0)
+          push, pop : in std_logic;
+          DataIn : in std_logic_vector(DATA_WIDTH-1 downto 0);
+          top : out std_logic_vector(DATA_WIDTH-1 downto 0)); --smallest element
+end stream_heap;
+
+architecture Behavioral of stream_heap is
+    constant LEVELS : integer := MEM_ADDR_WIDTH + 1; --positions 1 .. 2^13
+    constant EMPTY : unsigned(DATA_WIDTH downto 0) := (DATA_WIDTH => '1', others => '0');
+    type key_array is array (0 to LEVELS-1) of unsigned(DATA_WIDTH downto 0);
+    type pos_array is array (0 to LEVELS-1) of unsigned(MEM_ADDR_WIDTH downto 0);
+    type word_array is array (0 to LEVELS-1) of std_logic_vector(DATA_WIDTH downto 0);
+    type addr_array is array (0 to LEVELS-1) of std_logic_vector(MEM_ADDR_WIDTH-1 downto 0);
+    --tokens: valid, phase ('0' read, '1' write), pop, carried value, position
+    signal tv, tph, tpop : std_logic_vector(0 to LEVELS-1) := (others => '0');
+    signal tval : key_array;
+    signal tpos : pos_array; --push: target position, pop: hole position
+    signal node_pos : pos_array; --node of the token at its level
+    signal addra, addrb : addr_array;
+    signal wea : std_logic_vector(0 to LEVELS-1);
+    signal dina, douta, doutb : word_array;
+    signal count : unsigned(MEM_ADDR_WIDTH downto 0) := (others => '0');
+    signal top_r : unsigned(DATA_WIDTH downto 0) := EMPTY;
+
+    --level of heap position p: index of its most significant '1'
+    function level(p : unsigned) return integer is
+        variable l : integer;
+    begin
+        l := 0;
+        for b in p'range loop
+            if p(b) = '1' and b > l then
+                l := b;
+            end if;
+        end loop;
+        return l;
+    end level;
+
+    --ancestor of position p at level l (p itself when l >= level(p))
+    function ancestor(p : unsigned; l : integer) return unsigned is
+    begin
+        if level(p) > l then
+            return shift_right(p, level(p) - l);
+        end if;
+        return p;
+    end ancestor;
+
+    --RAM address width of level l; the last level only holds position 2^13
+    function level_width(l : integer) return integer is
+    begin
+        if l = LEVELS-1 then
+            return 1;
+        end if;
+        return l;
+    end level_width;
+begin
+
+    --node addressed by each token at its own level
+    pos_gen : for l in 0 to LEVELS-1 generate
+        node_pos(l) <= tpos(l) when (tpop(l) = '1') else ancestor(tpos(l), l);
+    end generate;
+
+    --one RAM per level; port A belongs to stage l except while stage l-1
+    --reads the two children of its hole (ports A and B)
+    level_gen : for l in 1 to LEVELS-1 generate
+        constant AW : integer := level_width(l);
+        signal child_rd : std_logic;
+    begin
+        level_ram : entity work.RAM(Behavioral)
+            Generic Map(ADDR_WIDTH => AW,
+                        DATA_WIDTH => DATA_WIDTH + 1)
+            Port Map(clk => clk,
+                     wea => wea(l),
+                     web => '0',
+                     addra => addra(l)(AW-1 downto 0),
+                     addrb => addrb(l)(AW-1 downto 0),
+                     dina => dina(l),
+                     dinb => (others => '0'),
+                     douta => douta(l),
+                     doutb => doutb(l));
+
+        child_rd <= tv(l-1) and tpop(l-1) and not tph(l-1);
+        --children of hole h: positions 2h and 2h+1
+        addra(l) <= std_logic_vector(resize(shift_left(tpos(l-1), 1), MEM_ADDR_WIDTH)) when (child_rd = '1') else
+                    std_logic_vector(resize(node_pos(l), MEM_ADDR_WIDTH));
+        addrb(l) <= std_logic_vector(resize(shift_left(tpos(l-1), 1) + 1, MEM_ADDR_WIDTH));
+    end generate;
+
+    --write port of each level (phase 1 of stage l)
+    process(tv, tph, tpop, tval, tpos, node_pos, douta, doutb, count)
+        variable node, c0, c1 : unsigned(DATA_WIDTH downto 0);
+        variable cpos : unsigned(MEM_ADDR_WIDTH + 1 downto 0);
+    begin
+        for l in 1 to LEVELS-1 loop
+            wea(l) <= '0';
+            dina(l) <= (others => '0');
+            if (tv(l) = '1' and tph(l) = '1') then
+                if (tpop(l) = '0') then
+                    node := unsigned(douta(l));
+                    if (level(tpos(l)) = l or tval(l) < node) then
+                        wea(l) <= '1';
+                        dina(l) <= std_logic_vector(tval(l));
+                    end if;
+                else
+                    --smaller child (or empty) moves up into the hole
+                    cpos := resize(shift_left(resize(tpos(l), MEM_ADDR_WIDTH + 2), 1), MEM_ADDR_WIDTH + 2);
+                    c0 := EMPTY;
+                    c1 := EMPTY;
+                    if (l < LEVELS-1) then
+                        if (cpos <= count) then
+                            c0 := unsigned(douta(l+1));
+                        end if;
+                        if (cpos + 1 <= count) then
+                            c1 := unsigned(doutb(l+1));
+                        end if;
+                    end if;
+                    wea(l) <= '1';
+                    if (c1 < c0) then
+                        dina(l) <= std_logic_vector(c1);
+                    else
+                        dina(l) <= std_logic_vector(c0);
+                    end if;
+                end if;
+            end if;
+        end loop;
+    end process;
+
+    --token pipeline, top register and element count
+    process(clk)
+        variable node, c0, c1, m : unsigned(DATA_WIDTH downto 0);
+        variable cpos : unsigned(MEM_ADDR_WIDTH + 1 downto 0);
+        variable go_on : boolean;
+    begin
+        if rising_edge(clk) then
+            for l in LEVELS-1 downto 0 loop
+                if (tv(l) = '1') then
+                    if (tph(l) = '0') then
+                        tph(l) <= '1';
+                    else
+                        tv(l) <= '0';
+                        go_on := false;
+                        if (tpop(l) = '0') then
+                            --push: larger value continues towards the target
+                            if (l = 0) then
+                                node := top_r;
+                            else
+                                node := unsigned(douta(l));
+                            end if;
+                            if (level(tpos(l)) = l) then
+                                if (l = 0) then
+                                    top_r <= tval(l);
+                                end if;
+                            else
+                                go_on := true;
+                                if (tval(l) < node) then
+                                    if (l = 0) then
+                                        top_r <= tval(l);
+                                    end if;
+                                    m := node;
+                                else
+                                    m := tval(l);
+                                end if;
+                            end if;
+                            if (go_on and l < LEVELS-1) then
+                                tval(l+1) <= m;
+                                tpos(l+1) <= tpos(l);
+                            end if;
+                        else
+                            --pop: hole moves to the smaller child
+                            cpos := resize(shift_left(resize(tpos(l), MEM_ADDR_WIDTH + 2), 1), MEM_ADDR_WIDTH + 2);
+                            c0 := EMPTY;
+                            c1 := EMPTY;
+                            if (l < LEVELS-1) then
+                                if (cpos <= count) then
+                                    c0 := unsigned(douta(l+1));
+                                end if;
+                                if (cpos + 1 <= count) then
+                                    c1 := unsigned(doutb(l+1));
+                                end if;
+                            end if;
+                            if (c1 < c0) then
+                                m := c1;
+                                cpos := cpos + 1;
+                            else
+                                m := c0;
+                            end if;
+                            if (l = 0) then
+                                top_r <= m;
+                            end if;
+                            if (m(DATA_WIDTH) = '0' and l < LEVELS-1) then
+                                go_on := true;
+                                tpos(l+1) <= resize(cpos, MEM_ADDR_WIDTH + 1);
+                            end if;
+                        end if;
+                        if (go_on and l < LEVELS-1) then
+                            tv(l+1) <= '1';
+                            tph(l+1) <= '0';
+                            tpop(l+1) <= tpop(l);
+                        end if;
+                    end if;
+                end if;
+            end loop;
+
+            --new host token enters level 0
+            if (push = '1') then
+                tv(0) <= '1';
+                tph(0) <= '0';
+                tpop(0) <= '0';
+                tval(0) <= '0' & unsigned(DataIn);
+                tpos(0) <= count + 1;
+                count <= count + 1;
+            elsif (pop = '1') then
+                tv(0) <= '1';
+                tph(0) <= '0';
+                tpop(0) <= '1';
+                tpos(0) <= to_unsigned(1, MEM_ADDR_WIDTH + 1);
+            end if;
+
+            if (clr = '1') then
+                tv <= (others => '0');
+                count <= (others => '0');
+                top_r <= EMPTY;
+            end if;
+        end if;
+    end process;
+
+    top <= std_logic_vector(top_r(DATA_WIDTH-1 downto 0));
+
+end Behavioral;
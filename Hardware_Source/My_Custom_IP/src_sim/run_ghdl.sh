@@ -0,0 +1,30 @@
+#!/bin/sh
+# Runs both testbenches with GHDL and keeps the transcripts in reports/.
+# A failed elaboration or assertion stops the script with exit status 1.
+#   cd Hardware_Source/My_Custom_IP && sh src_sim/run_ghdl.sh
+mkdir -p reports work_ghdl
+G="--std=08 -frelaxed --workdir=work_ghdl"
+
+# run NAME COMMAND...: transcript in reports/NAME.txt
+run() {
+	name=$1
+	shift
+	if "$@" > reports/$name.txt 2>&1; then
+		cat reports/$name.txt
+	else
+		cat reports/$name.txt
+		echo "FAILED: $name"
+		exit 1
+	fi
+}
+
+run ghdl_import ghdl -i $G src_rtl/*.vhd ../SoC_Top_System/bridge/*.vhd \
+	../Standard_FPro_Library/mmio/mmio_support/chu_mmio_controller.vhd \
+	src_sim/tb_chu_sorting_core.vhd src_sim/tb_chu_mmio_controller.vhd
+
+run ghdl_make_sorting_core ghdl -m $G tb_chu_sorting_core
+run tb_chu_sorting_core ghdl -r $G tb_chu_sorting_core --assert-level=error
+run tb_chu_sorting_core_radix4 ghdl -r $G tb_chu_sorting_core -gRADIX_BITS=4 --assert-level=error
+
+run ghdl_make_mmio_controller ghdl -m $G tb_chu_mmio_controller
+run tb_chu_mmio_controller ghdl -r $G tb_chu_mmio_controller --assert-level=error
@@ -0,0 +1,293 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 10/17/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: tb_chu_mmio_controller - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / GHDL
+----------------------------------------------------------------------------------
+-- Self-checking testbench of the bus monitor of chu_mmio_controller
+-- (MON_SLOT = 14, MON_SLOTS = 16) behind chu_mcs_bridge. The MCS accesses
+-- are made like in tb_chu_sorting_core. Slot n answers n, and slot 4
+-- holds its accesses with fp_ready for STALL clocks like chu_sorting_core,
+-- so a strobe the bridge keeps pending must still count once.
+-- Each round makes a known mix of slot 3 and slot 4 reads and writes and
+-- video reads and writes, then reads the counters like BusMonitor::snapshot():
+-- freeze write, cycle counter, reads (SEL = 0), writes (SEL = 1), unfreeze.
+-- Checked per round:
+--  * every counter against the accesses made since the clear; the
+--    freeze write of each snapshot counts (one slot 14 write per round),
+--    the readout and the unfreeze write do not
+--  * the cycle counter holds while frozen and runs again after the unfreeze
+--  * the read data mux (slot 3 answers 3, register 0 of slot 14 MON_SLOTS)
+-- Rounds with GAP idle clocks and with back-to-back accesses. Ends with a
+-- failure assertion on any error.
+--
+-- GHDL (from Hardware_Source/My_Custom_IP):
+--   ghdl -i --std=08 ../SoC_Top_System/bridge/*.vhd ../Standard_FPro_Library/mmio/mmio_support/chu_mmio_controller.vhd src_sim/tb_chu_mmio_controller.vhd
+--   ghdl -m --std=08 tb_chu_mmio_controller
+--   ghdl -r --std=08 tb_chu_mmio_controller
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.chu_io_map.all;
+
+entity tb_chu_mmio_controller is
+end tb_chu_mmio_controller;
+
+architecture Behavioral of tb_chu_mmio_controller is
+    constant T : time := 10 ns; --100 MHz
+    constant GAP : integer := 4; --idle clocks after a bus access (MCS I/O bus)
+    constant STALL : integer := 4; --slot 4 takes one access per STALL clocks
+    constant MON_SLOT : integer := 14;
+    constant MON_SLOTS : integer := 16;
+    --bus monitor registers (BusMonitor)
+    constant REG_CTRL : integer := 0;
+    constant REG_SEL : integer := 1;
+    constant REG_CYCLE_LOWER : integer := 2;
+    constant REG_CYCLE_UPPER : integer := 3;
+    constant REG_VIDEO : integer := 4;
+    constant REG_COUNT : integer := 16;
+    constant CLR_BIT : integer := 1;
+    constant FREEZE_BIT : integer := 2;
+    --word address of the video space behind the bridge
+    constant VIDEO_WORD : integer := 16#200000#;
+
+    signal clk : std_logic := '0';
+    signal reset : std_logic := '1';
+    --MCS I/O bus side of the bridge
+    signal io_read_strobe, io_write_strobe : std_logic := '0';
+    signal io_address, io_write_data : std_logic_vector(31 downto 0) := (others => '0');
+    signal io_read_data, fp_rd_data : std_logic_vector(31 downto 0);
+    signal io_ready : std_logic;
+    signal fp_video_cs, fp_mmio_cs, fp_wr, fp_rd, fp_ready : std_logic;
+    signal fp_addr : std_logic_vector(20 downto 0);
+    signal fp_wr_data, mmio_rd_data : std_logic_vector(31 downto 0);
+    --slot interface
+    signal slot_cs_array, slot_mem_rd_array, slot_mem_wr_array : std_logic_vector(63 downto 0);
+    signal slot_reg_addr_array : slot_2d_reg_type;
+    signal slot_rd_data_array, slot_wr_data_array : slot_2d_data_type;
+    signal s4_gap : integer range 0 to STALL - 1;
+    signal finished : boolean := false;
+begin
+    clk <= not clk after T / 2 when not finished else '0';
+
+    bridge : entity work.chu_mcs_bridge
+        Port Map(clk => clk,
+                 reset => reset,
+                 io_addr_strobe => '0',
+                 io_read_strobe => io_read_strobe,
+                 io_write_strobe => io_write_strobe,
+                 io_byte_enable => "1111",
+                 io_address => io_address,
+                 io_write_data => io_write_data,
+                 io_read_data => io_read_data,
+                 io_ready => io_ready,
+                 fp_video_cs => fp_video_cs,
+                 fp_mmio_cs => fp_mmio_cs,
+                 fp_wr => fp_wr,
+                 fp_rd => fp_rd,
+                 fp_addr => fp_addr,
+                 fp_wr_data => fp_wr_data,
+                 fp_rd_data => fp_rd_data,
+                 fp_ready => fp_ready);
+
+    dut : entity work.chu_mmio_controller
+        Generic Map(MON_SLOT => MON_SLOT,
+                    MON_SLOTS => MON_SLOTS)
+        Port Map(clk => clk,
+                 reset => reset,
+                 mmio_cs => fp_mmio_cs,
+                 mmio_wr => fp_wr,
+                 mmio_rd => fp_rd,
+                 mmio_addr => fp_addr,
+                 mmio_wr_data => fp_wr_data,
+                 mmio_rd_data => mmio_rd_data,
+                 video_cs => fp_video_cs,
+                 slot_cs_array => slot_cs_array,
+                 slot_mem_rd_array => slot_mem_rd_array,
+                 slot_mem_wr_array => slot_mem_wr_array,
+                 slot_reg_addr_array => slot_reg_addr_array,
+                 slot_rd_data_array => slot_rd_data_array,
+                 slot_wr_data_array => slot_wr_data_array);
+
+    --slot n answers n, the video space x"0000CAFE"
+    gen_slots : for i in 0 to 63 generate
+        slot_rd_data_array(i) <= std_logic_vector(to_unsigned(i, 32));
+    end generate;
+    fp_rd_data <= x"0000CAFE" when fp_video_cs = '1' else mmio_rd_data;
+
+    --slot 4 holds an access for STALL clocks after the last one (ready of chu_sorting_core)
+    process(clk, reset)
+    begin
+        if reset = '1' then
+            s4_gap <= STALL - 1;
+        elsif rising_edge(clk) then
+            if slot_cs_array(4) = '1' and (fp_rd = '1' or fp_wr = '1') then
+                s4_gap <= 0;
+            elsif s4_gap < STALL - 1 then
+                s4_gap <= s4_gap + 1;
+            end if;
+        end if;
+    end process;
+    fp_ready <= '0' when slot_cs_array(4) = '1' and s4_gap < STALL - 1 else '1';
+
+    stim : process
+        type count_array is array (0 to MON_SLOTS - 1) of natural;
+        variable rd_cnt, wr_cnt, rd_exp, wr_exp : count_array;
+        variable vrd_cnt, vwr_cnt, vrd_exp, vwr_exp : natural;
+        variable cycles, c0, c1 : natural;
+        variable d : std_logic_vector(31 downto 0);
+        variable tests, errors : natural := 0;
+        variable idle : natural := GAP; --idle clocks after a bus access
+
+        --one MCS I/O bus access of word address a
+        procedure mcs_access(constant wr : in boolean; constant a : in integer;
+                             constant wdata : in std_logic_vector(31 downto 0);
+                             variable rdata : out std_logic_vector(31 downto 0)) is
+        begin
+            io_address <= std_logic_vector(unsigned'(x"C0000000") + to_unsigned(4 * a, 32));
+            io_write_data <= wdata;
+            if wr then
+                io_write_strobe <= '1';
+            else
+                io_read_strobe <= '1';
+            end if;
+            loop
+                wait until falling_edge(clk);
+                exit when io_ready = '1';
+                wait until rising_edge(clk);
+                io_read_strobe <= '0';
+                io_write_strobe <= '0';
+            end loop;
+            rdata := io_read_data;
+            wait until rising_edge(clk);
+            io_read_strobe <= '0';
+            io_write_strobe <= '0';
+            for g in 1 to idle loop
+                wait until rising_edge(clk);
+            end loop;
+        end procedure;
+
+        procedure slot_write(constant slot, reg, data : in integer) is
+            variable r : std_logic_vector(31 downto 0);
+        begin
+            mcs_access(true, slot * 32 + reg, std_logic_vector(to_unsigned(data, 32)), r);
+        end procedure;
+
+        procedure slot_read(constant slot, reg : in integer; variable data : out natural) is
+            variable r : std_logic_vector(31 downto 0);
+        begin
+            mcs_access(false, slot * 32 + reg, x"00000000", r);
+            data := to_integer(unsigned(r(30 downto 0)));
+        end procedure;
+
+        procedure check(constant ok : in boolean; constant msg : in string) is
+        begin
+            tests := tests + 1;
+            if not ok then
+                errors := errors + 1;
+                report "tb_chu_mmio_controller: " & msg severity error;
+            end if;
+        end procedure;
+
+        --BusMonitor::snapshot(): every counter with counting frozen
+        procedure snapshot is
+            variable n : natural;
+        begin
+            slot_write(MON_SLOT, REG_CTRL, FREEZE_BIT);
+            slot_read(MON_SLOT, REG_CYCLE_LOWER, cycles);
+            slot_read(MON_SLOT, REG_CYCLE_UPPER, n);
+            slot_read(MON_SLOT, REG_CYCLE_LOWER, c0);
+            check(c0 = cycles, "cycle counter runs while frozen");
+            slot_write(MON_SLOT, REG_SEL, 0);
+            for i in 0 to MON_SLOTS - 1 loop
+                slot_read(MON_SLOT, REG_COUNT + i, rd_cnt(i));
+            end loop;
+            slot_read(MON_SLOT, REG_VIDEO, vrd_cnt);
+            slot_write(MON_SLOT, REG_SEL, 1);
+            for i in 0 to MON_SLOTS - 1 loop
+                slot_read(MON_SLOT, REG_COUNT + i, wr_cnt(i));
+            end loop;
+            slot_read(MON_SLOT, REG_VIDEO, vwr_cnt);
+            slot_write(MON_SLOT, REG_CTRL, 0);
+        end procedure;
+
+        --slot 3 and slot 4 reads and writes, video reads and writes
+        procedure traffic(constant n3, n4, nv : in integer) is
+            variable x : natural;
+        begin
+            for i in 1 to n3 loop
+                slot_write(3, 1, i);
+                slot_read(3, 2, x);
+                check(x = 3, "slot 3 read returned " & integer'image(x));
+                slot_read(3, 5, x);
+            end loop;
+            rd_exp(3) := rd_exp(3) + 2 * n3;
+            wr_exp(3) := wr_exp(3) + n3;
+            for i in 1 to n4 loop
+                slot_write(4, 0, i);
+                slot_read(4, 1, x);
+                check(x = 4, "slot 4 read returned " & integer'image(x));
+            end loop;
+            rd_exp(4) := rd_exp(4) + n4;
+            wr_exp(4) := wr_exp(4) + n4;
+            for i in 1 to nv loop
+                mcs_access(false, VIDEO_WORD + 16#10000# + i, x"00000000", d);
+                mcs_access(true, VIDEO_WORD + 16#10000# + i, x"00000000", d);
+                mcs_access(true, VIDEO_WORD + i, x"00000000", d);
+            end loop;
+            vrd_exp := vrd_exp + nv;
+            vwr_exp := vwr_exp + 2 * nv;
+        end procedure;
+
+        procedure round(constant n3, n4, nv : in integer) is
+        begin
+            traffic(n3, n4, nv);
+            snapshot;
+            wr_exp(MON_SLOT) := wr_exp(MON_SLOT) + 1; --the freeze write
+            for i in 0 to MON_SLOTS - 1 loop
+                check(rd_cnt(i) = rd_exp(i), "slot " & integer'image(i) & " reads " &
+                      integer'image(rd_cnt(i)) & ", expected " & integer'image(rd_exp(i)));
+                check(wr_cnt(i) = wr_exp(i), "slot " & integer'image(i) & " writes " &
+                      integer'image(wr_cnt(i)) & ", expected " & integer'image(wr_exp(i)));
+            end loop;
+            check(vrd_cnt = vrd_exp, "video reads " & integer'image(vrd_cnt) & ", expected " & integer'image(vrd_exp));
+            check(vwr_cnt = vwr_exp, "video writes " & integer'image(vwr_cnt) & ", expected " & integer'image(vwr_exp));
+            slot_read(MON_SLOT, REG_CYCLE_LOWER, c1);
+            check(c1 > cycles, "cycle counter does not resume after the unfreeze");
+            rd_exp(MON_SLOT) := rd_exp(MON_SLOT) + 1; --that read
+        end procedure;
+
+    begin
+        rd_exp := (others => 0);
+        wr_exp := (others => 0);
+        vrd_exp := 0;
+        vwr_exp := 0;
+        wait for 3 * T;
+        wait until rising_edge(clk);
+        reset <= '0';
+        wait until rising_edge(clk);
+
+        slot_read(MON_SLOT, REG_CTRL, c0);
+        check(c0 = MON_SLOTS, "MON_SLOTS read " & integer'image(c0));
+        slot_write(MON_SLOT, REG_CTRL, CLR_BIT); --clears its own count too
+
+        round(5, 7, 3);
+        round(2, 0, 9);
+        --back-to-back accesses: slot 4 holds them with fp_ready
+        idle := 0;
+        round(6, 11, 4);
+        round(0, 13, 0);
+
+        assert errors = 0
+            report "tb_chu_mmio_controller: " & integer'image(errors) & " of " & integer'image(tests) & " checks FAILED"
+            severity failure;
+        report "tb_chu_mmio_controller: all " & integer'image(tests) & " checks passed" severity note;
+        finished <= true;
+        wait;
+    end process;
+
+end Behavioral;
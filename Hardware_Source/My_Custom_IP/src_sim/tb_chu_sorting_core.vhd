@@ -0,0 +1,452 @@
+----------------------------------------------------------------------------------
+-- Company: George Mason
+-- Engineer: Kainoa Asse
+-- Create Date: 10/17/2026
+-- Design Name: Sorting core on FPro System
+-- Module Name: tb_chu_sorting_core - Behavioral
+-- Target Devices: Basys 3 (Artix-7)
+-- Tool Versions: Vivado 2023.x / GHDL
+----------------------------------------------------------------------------------
+-- Self-checking testbench of chu_sorting_core (NET_LANES = 0, SEL_LANES = 1,
+-- KEY_WIDTH = 16, INDEX = false). Every test goes through the slot
+-- interface like SortCore: N_REG, init_write, N x MEMW_ri, s = 1, s = 0,
+-- init_read, N x MEMR_ri, STATUS_REG. All accesses go through
+-- chu_mcs_bridge like the MCS makes them: io_read_strobe/io_write_strobe for
+-- one clock, address and write data held until io_ready = '1', read data
+-- sampled on the falling edge of that clock (the strobe clock unless the
+-- bridge waits), then idle clocks (GAP, or 0 for back-to-back accesses).
+-- A monitor asserts that the core never sees two accesses closer than
+-- HOST_GAP clocks (its ready output holds them in the bridge).
+-- Checked per test:
+--  * readback in ascending order and the same multiset as the loaded keys
+--    (ALG_SELECT: MEM[K-1] = K-th smallest key, read through ADDR/DATA)
+--  * STATUS_REG SORTED and CHECK bits after the readback (full sorts)
+--  * clocks from the edge that latches s = 1 to the edge that enters S4
+--    (rising edge of Done, phase(3)), against the latency of the engine:
+--      ALG_SELECTION (N^2+3N)/2 - 1          33,566,719 at N = 8192, 1 at N = 1
+--      ALG_MERGE     N (log2 N + 1)            114,688 at N = 8192
+--      ALG_RADIX     1 + passes (2N + 2^RADIX_BITS + 5)  33,291 at N = 8192
+--      ALG_SELECT    1 + sum over passes of (2m + 2^RADIX_BITS + 5),
+--                    m = keys equal to the result in the digits above
+--      ALG_STREAM, ALG_HIST  1 (s goes straight to S4)
+-- Tests: LFSR and descending data for every algorithm at N = 16 and
+-- N = BIG_N, selection sort at N = 16 and N = SEL_N (SEL_N = 8192 runs
+-- the 33.5M-clock sort), ALG_HIST on 8-bit keys, ALG_SELECT for rank 1,
+-- the median and the maximum, packed transfers (MEMW2/MEMR2) and a
+-- readback through the memory window, then a set of tests with
+-- back-to-back accesses. Ends with a failure assertion on any error.
+--
+-- GHDL (from Hardware_Source/My_Custom_IP; RAM.vhd needs -frelaxed for its
+-- shared variable):
+--   ghdl -i --std=08 -frelaxed src_rtl/*.vhd ../SoC_Top_System/bridge/*.vhd src_sim/tb_chu_sorting_core.vhd
+--   ghdl -m --std=08 -frelaxed tb_chu_sorting_core
+--   ghdl -r --std=08 -frelaxed tb_chu_sorting_core
+--   ghdl -r --std=08 -frelaxed tb_chu_sorting_core -gSEL_N=8192 -gRADIX_BITS=4
+
+library IEEE;
+use IEEE.STD_LOGIC_1164.ALL;
+use IEEE.NUMERIC_STD.ALL;
+use work.sort_core_pkg.all;
+
+entity tb_chu_sorting_core is
+    Generic(RADIX_BITS : integer := 8;
+            SEL_N : integer := 1024; --largest selection sort test (power of 2)
+            BIG_N : integer := 8192); --merge/radix/stream/hist/select tests (power of 2)
+end tb_chu_sorting_core;
+
+architecture Behavioral of tb_chu_sorting_core is
+    constant T : time := 10 ns; --100 MHz
+    constant GAP : integer := 4; --idle clocks after a bus access (MCS I/O bus)
+    constant KEY_WIDTH : integer := 16;
+    constant PASSES : integer := (KEY_WIDTH + RADIX_BITS - 1) / RADIX_BITS;
+    --registers
+    constant REG_MEMW : integer := 0;
+    constant REG_MEMR : integer := 1;
+    constant REG_N : integer := 2;
+    constant REG_CTRL : integer := 3;
+    constant REG_STATUS : integer := 4;
+    constant REG_MEMW2 : integer := 5;
+    constant REG_MEMR2 : integer := 6;
+    constant REG_K : integer := 14;
+    constant REG_ADDR : integer := 16;
+    constant REG_DATA : integer := 17;
+    --word addresses behind the bridge: slot 4 (S4_USER) and the memory
+    --window in video slot 4 (get_sprite_addr(BRIDGE_BASE, V4_USER4))
+    constant SLOT_WORD : integer := 4 * 32;
+    constant WIN_WORD : integer := 16#210000#;
+    --readback of run_test
+    constant XFER_SINGLE : integer := 0; --MEMW_ri/MEMR_ri
+    constant XFER_PACKED : integer := 1; --MEMW2/MEMR2
+    constant XFER_WIN : integer := 2; --MEMW_ri, memory window readback
+    --CTRL_REG bits
+    constant S_BIT : integer := 1;
+    constant INIT_BIT : integer := 2;
+    constant RW_BIT : integer := 4;
+    --STATUS_REG bits
+    constant SORTED_BIT : integer := 4;
+    constant CHECK_BIT : integer := 5;
+
+    signal clk : std_logic := '0';
+    signal reset : std_logic := '1';
+    signal cs, win_cs, ready : std_logic;
+    signal addr : std_logic_vector(4 downto 0);
+    signal rd_data, wr_data : std_logic_vector(31 downto 0);
+    signal win_addr : std_logic_vector(12 downto 0);
+    signal win_rd_data : std_logic_vector(31 downto 0);
+    signal phase : std_logic_vector(5 downto 0);
+    signal irq : std_logic;
+    --MCS I/O bus side of the bridge
+    signal io_read_strobe, io_write_strobe : std_logic := '0';
+    signal io_address, io_write_data : std_logic_vector(31 downto 0) := (others => '0');
+    signal io_read_data, fp_rd_data : std_logic_vector(31 downto 0);
+    signal io_ready : std_logic;
+    signal fp_video_cs, fp_mmio_cs, fp_wr, fp_rd : std_logic;
+    signal fp_addr : std_logic_vector(20 downto 0);
+    signal finished : boolean := false;
+begin
+    clk <= not clk after T / 2 when not finished else '0';
+
+    dut : entity work.chu_sorting_core
+        Generic Map(NET_LANES => 0,
+                    SEL_LANES => 1,
+                    KEY_WIDTH => KEY_WIDTH,
+                    INDEX => false,
+                    RADIX_BITS => RADIX_BITS)
+        Port Map(clk => clk,
+                 reset => reset,
+                 cs => cs,
+                 write => fp_wr,
+                 read => fp_rd,
+                 addr => addr,
+                 rd_data => rd_data,
+                 wr_data => wr_data,
+                 win_cs => win_cs,
+                 win_addr => win_addr,
+                 win_rd_data => win_rd_data,
+                 phase => phase,
+                 ready => ready,
+                 irq => irq);
+
+    bridge : entity work.chu_mcs_bridge
+        Port Map(clk => clk,
+                 reset => reset,
+                 io_addr_strobe => '0',
+                 io_read_strobe => io_read_strobe,
+                 io_write_strobe => io_write_strobe,
+                 io_byte_enable => "1111",
+                 io_address => io_address,
+                 io_write_data => io_write_data,
+                 io_read_data => io_read_data,
+                 io_ready => io_ready,
+                 fp_video_cs => fp_video_cs,
+                 fp_mmio_cs => fp_mmio_cs,
+                 fp_wr => fp_wr,
+                 fp_rd => fp_rd,
+                 fp_addr => fp_addr,
+                 fp_wr_data => wr_data,
+                 fp_rd_data => fp_rd_data,
+                 fp_ready => ready);
+    --decoding of chu_mmio_controller, mmio_sys_sampler_basys3 and mcs_top_sampler_basys3
+    cs <= '1' when fp_mmio_cs = '1' and to_integer(unsigned(fp_addr(10 downto 5))) = SLOT_WORD / 32 else '0';
+    addr <= fp_addr(4 downto 0);
+    win_cs <= '1' when fp_video_cs = '1' and fp_addr(16 downto 14) = "100" else '0';
+    win_addr <= fp_addr(12 downto 0);
+    fp_rd_data <= win_rd_data when fp_video_cs = '1' else rd_data;
+
+    --spacing of the accesses that reach the core
+    spacing : process(clk)
+        variable since : integer := HOST_GAP;
+    begin
+        if rising_edge(clk) then
+            if ((cs = '1' or win_cs = '1') and (fp_rd = '1' or fp_wr = '1')) then
+                assert since >= HOST_GAP
+                    report "tb_chu_sorting_core: core accesses " & integer'image(since) & " clocks apart"
+                    severity failure;
+                since := 1;
+            elsif (since < HOST_GAP) then
+                since := since + 1;
+            end if;
+        end if;
+    end process;
+
+    stim : process
+        type count_array is array (0 to 2**KEY_WIDTH - 1) of natural;
+        variable hist : count_array; --keys loaded and not yet read back
+        variable lfsr : unsigned(15 downto 0);
+        variable tests, errors : natural := 0;
+        variable idle : natural := GAP; --idle clocks after a bus access
+
+        --one MCS I/O bus access of word address a
+        procedure mcs_access(constant wr : in boolean; constant a : in integer;
+                             constant wdata : in std_logic_vector(31 downto 0);
+                             variable rdata : out std_logic_vector(31 downto 0)) is
+        begin
+            io_address <= std_logic_vector(unsigned'(x"C0000000") + to_unsigned(4 * a, 32));
+            io_write_data <= wdata;
+            if wr then
+                io_write_strobe <= '1';
+            else
+                io_read_strobe <= '1';
+            end if;
+            loop
+                wait until falling_edge(clk);
+                exit when io_ready = '1';
+                wait until rising_edge(clk);
+                io_read_strobe <= '0';
+                io_write_strobe <= '0';
+            end loop;
+            rdata := io_read_data;
+            wait until rising_edge(clk);
+            io_read_strobe <= '0';
+            io_write_strobe <= '0';
+            for g in 1 to idle loop
+                wait until rising_edge(clk);
+            end loop;
+        end procedure;
+
+        procedure bus_write_w(constant reg : in integer; constant data : in std_logic_vector(31 downto 0)) is
+            variable d : std_logic_vector(31 downto 0);
+        begin
+            mcs_access(true, SLOT_WORD + reg, data, d);
+        end procedure;
+
+        procedure bus_write(constant reg : in integer; constant data : in integer) is
+        begin
+            bus_write_w(reg, std_logic_vector(to_unsigned(data, 32)));
+        end procedure;
+
+        procedure bus_read_w(constant reg : in integer; variable data : out std_logic_vector(31 downto 0)) is
+        begin
+            mcs_access(false, SLOT_WORD + reg, x"00000000", data);
+        end procedure;
+
+        procedure bus_read(constant reg : in integer; variable data : out integer) is
+            variable d : std_logic_vector(31 downto 0);
+        begin
+            bus_read_w(reg, d);
+            data := to_integer(unsigned(d(30 downto 0)));
+        end procedure;
+
+        --memory window word k
+        procedure win_read(constant k : in integer; variable data : out integer) is
+            variable d : std_logic_vector(31 downto 0);
+        begin
+            mcs_access(false, WIN_WORD + k, x"00000000", d);
+            data := to_integer(unsigned(d(30 downto 0)));
+        end procedure;
+
+        --Galois LFSR x^16 + x^14 + x^13 + x^11 + 1
+        procedure lfsr_step is
+        begin
+            if (lfsr(0) = '1') then
+                lfsr := shift_right(lfsr, 1) xor x"B400";
+            else
+                lfsr := shift_right(lfsr, 1);
+            end if;
+        end procedure;
+
+        function log2(n : integer) return integer is
+            variable m : integer := 0;
+        begin
+            while 2**m < n loop
+                m := m + 1;
+            end loop;
+            return m;
+        end function;
+
+        --pattern 0: LFSR, 1: descending; K: rank of ALG_SELECT (1..N);
+        --xfer: XFER_SINGLE, XFER_PACKED (N even, 16-bit keys) or XFER_WIN
+        procedure run_test(constant alg : in std_logic_vector(2 downto 0); constant n : in integer;
+                           constant pattern : in integer; constant k : in integer;
+                           constant xfer : in integer := XFER_SINGLE) is
+            variable mode, key, lo, prev, clocks, expect, stat, acc, ans, m, sh, g : integer;
+            variable bad : boolean;
+            variable w : std_logic_vector(31 downto 0);
+
+            --next key read back: ascending and one of the loaded keys
+            procedure take(constant x : in integer) is
+            begin
+                if (x < prev or x > hist'high) then
+                    bad := true;
+                elsif (hist(x) = 0) then
+                    bad := true;
+                else
+                    hist(x) := hist(x) - 1;
+                    prev := x;
+                end if;
+            end procedure;
+        begin
+            tests := tests + 1;
+            mode := to_integer(unsigned(alg)) * 8;
+            for x in hist'range loop
+                hist(x) := 0;
+            end loop;
+
+            --load
+            bus_write(REG_N, n);
+            bus_write(REG_K, k);
+            bus_write(REG_CTRL, mode);
+            bus_write(REG_CTRL, mode + RW_BIT + INIT_BIT);
+            lfsr := x"ACE1";
+            for i in 0 to n - 1 loop
+                if (pattern = 0) then
+                    lfsr_step;
+                    key := to_integer(lfsr);
+                else
+                    key := n - 1 - i;
+                end if;
+                if (alg = ALG_HIST) then
+                    key := key mod 256; --8-bit keys
+                end if;
+                hist(key) := hist(key) + 1;
+                if (xfer /= XFER_PACKED) then
+                    bus_write(REG_MEMW, key);
+                elsif (i mod 2 = 0) then
+                    lo := key;
+                else
+                    bus_write_w(REG_MEMW2, std_logic_vector(to_unsigned(key, 16)) &
+                                           std_logic_vector(to_unsigned(lo, 16)));
+                end if;
+            end loop;
+
+            --K-th smallest key (ALG_SELECT)
+            ans := 0;
+            acc := 0;
+            for x in hist'range loop
+                acc := acc + hist(x);
+                if (acc >= k) then
+                    ans := x;
+                    exit;
+                end if;
+            end loop;
+
+            --expected latency
+            if (alg = ALG_SELECTION) then
+                expect := (n * n + 3 * n) / 2 - 1;
+            elsif (alg = ALG_MERGE) then
+                expect := n * (log2(n) + 1);
+            elsif (alg = ALG_RADIX) then
+                expect := 1 + PASSES * (2 * n + 2**RADIX_BITS + 5);
+            elsif (alg = ALG_SELECT) then
+                expect := 1;
+                for q in 0 to PASSES - 1 loop
+                    sh := 2**((PASSES - q) * RADIX_BITS);
+                    m := 0;
+                    for x in hist'range loop
+                        if (x / sh = ans / sh) then
+                            m := m + hist(x);
+                        end if;
+                    end loop;
+                    expect := expect + 2 * m + 2**RADIX_BITS + 5;
+                end loop;
+            else
+                expect := 1;
+            end if;
+
+            --s = 1, clocks from the edge that latches it to the rising edge of Done
+            g := idle;
+            idle := 0;
+            bus_write(REG_CTRL, mode + S_BIT);
+            idle := g;
+            clocks := 0;
+            loop
+                wait until rising_edge(clk);
+                clocks := clocks + 1;
+                wait for 1 ns;
+                exit when (phase(3) = '1' or clocks > expect + 1000);
+            end loop;
+            for c in 1 to idle loop
+                wait until rising_edge(clk);
+            end loop;
+            bad := clocks /= expect;
+
+            --readback
+            bus_write(REG_CTRL, mode);
+            bus_write(REG_CTRL, mode + INIT_BIT);
+            if (alg = ALG_SELECT) then
+                bus_write(REG_ADDR, k - 1);
+                bus_read(REG_DATA, key);
+                bad := bad or key /= ans;
+            else
+                prev := 0;
+                if (xfer = XFER_PACKED) then
+                    for i in 0 to n / 2 - 1 loop
+                        bus_read_w(REG_MEMR2, w);
+                        take(to_integer(unsigned(w(15 downto 0))));
+                        take(to_integer(unsigned(w(31 downto 16))));
+                    end loop;
+                else
+                    for i in 0 to n - 1 loop
+                        if (xfer = XFER_WIN) then
+                            win_read(i, key);
+                        else
+                            bus_read(REG_MEMR, key);
+                        end if;
+                        take(key);
+                    end loop;
+                end if;
+                bus_read(REG_STATUS, stat);
+                if ((stat / 2**SORTED_BIT) mod 2 = 0 or (stat / 2**CHECK_BIT) mod 2 = 0) then
+                    bad := true;
+                end if;
+            end if;
+
+            if bad then
+                errors := errors + 1;
+            end if;
+            report "alg " & integer'image(to_integer(unsigned(alg))) & " N=" & integer'image(n) &
+                   " pattern " & integer'image(pattern) & " K=" & integer'image(k) &
+                   " xfer " & integer'image(xfer) & " idle " & integer'image(idle) &
+                   ": " & integer'image(clocks) & " clocks (expected " & integer'image(expect) & ")" &
+                   " -> " & boolean'image(not bad)
+                severity note;
+        end procedure;
+    begin
+        reset <= '1';
+        for c in 1 to 4 loop
+            wait until rising_edge(clk);
+        end loop;
+        reset <= '0';
+        wait until rising_edge(clk);
+
+        for p in 0 to 1 loop
+            run_test(ALG_SELECTION, 16, p, 0);
+            run_test(ALG_SELECTION, SEL_N, p, 0);
+            run_test(ALG_MERGE, 16, p, 0);
+            run_test(ALG_MERGE, BIG_N, p, 0);
+            run_test(ALG_RADIX, 16, p, 0);
+            run_test(ALG_RADIX, BIG_N, p, 0);
+            run_test(ALG_STREAM, 16, p, 0);
+            run_test(ALG_STREAM, BIG_N, p, 0);
+            run_test(ALG_HIST, 16, p, 0);
+            run_test(ALG_HIST, BIG_N, p, 0);
+        end loop;
+        run_test(ALG_SELECTION, 1, 0, 0); --N = 1: straight to S4, nothing overwritten
+        run_test(ALG_SELECTION, 1, 1, 1);
+        run_test(ALG_SELECT, 16, 0, 1);
+        run_test(ALG_SELECT, BIG_N, 0, BIG_N / 2);
+        run_test(ALG_SELECT, BIG_N, 1, 1);
+        run_test(ALG_SELECT, BIG_N, 0, BIG_N);
+        run_test(ALG_MERGE, 16, 0, 0, XFER_PACKED);
+        run_test(ALG_RADIX, BIG_N, 1, 0, XFER_PACKED);
+        run_test(ALG_MERGE, 16, 0, 0, XFER_WIN);
+        run_test(ALG_RADIX, BIG_N, 1, 0, XFER_WIN);
+
+        --back-to-back accesses: the core holds them with ready
+        idle := 0;
+        run_test(ALG_MERGE, BIG_N, 0, 0);
+        run_test(ALG_MERGE, BIG_N, 0, 0, XFER_PACKED);
+        run_test(ALG_MERGE, 16, 1, 0, XFER_WIN);
+        run_test(ALG_STREAM, BIG_N, 0, 0);
+        run_test(ALG_HIST, BIG_N, 1, 0);
+        run_test(ALG_SELECT, BIG_N, 0, BIG_N / 2);
+
+        assert errors = 0
+            report "tb_chu_sorting_core: " & integer'image(errors) & " of " & integer'image(tests) & " tests FAILED"
+            severity failure;
+        report "tb_chu_sorting_core: all " & integer'image(tests) & " tests passed" severity note;
+        finished <= true;
+        wait;
+    end process;
+
+end Behavioral;
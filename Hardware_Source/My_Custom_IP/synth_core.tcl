@@ -0,0 +1,23 @@
+#----------------------------------------------------------------------------------
+# Out-of-context synthesis of chu_sorting_core for the Basys 3 (XC7A35T), 100 MHz
+# clock as in basys3_chu.xdc. Writes the utilization and timing summaries to
+# reports/. Generics other than the defaults: -tclargs NAME=VALUE ...
+#   cd Hardware_Source/My_Custom_IP
+#   vivado -mode batch -source synth_core.tcl -log reports/synth.log
+#   vivado -mode batch -source synth_core.tcl -tclargs SEL_LANES=4
+#----------------------------------------------------------------------------------
+set tag default
+set generics {}
+foreach g $argv {
+    lappend generics -generic $g
+    set tag [string map {= _} $g]
+}
+file mkdir reports
+
+read_vhdl -vhdl2008 [glob src_rtl/*.vhd]
+synth_design -top chu_sorting_core -part xc7a35tcpg236-1 -mode out_of_context {*}$generics
+create_clock -name clk -period 10.00 [get_ports clk]
+
+report_utilization -file reports/utilization_$tag.txt
+report_utilization -hierarchical -file reports/utilization_hier_$tag.txt
+report_timing_summary -max_paths 10 -file reports/timing_$tag.txt
@@ -38,6 +38,7 @@ package chu_io_map is
    constant S11_PS2      : integer := 11;
    constant S12_DDFS     : integer := 12;
    constant S13_ADSR     : integer := 13;
+   constant S14_BUS_MON  : integer := 14; -- bus monitor of chu_mmio_controller
 
    -- *****************************************************************
    -- slot definition for the daisy video subsystem 
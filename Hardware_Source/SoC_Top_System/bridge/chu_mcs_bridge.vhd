@@ -5,6 +5,8 @@ use work.chu_io_map.all;
 entity chu_mcs_bridge is
    generic(BRG_BASE : std_logic_vector(31 downto 0) := x"C0000000");
    port(
+      clk             : in  std_logic;
+      reset           : in  std_logic;
       -- uBlaze MCS I/O bus
       io_addr_strobe  : in  std_logic;  -- not used 
       io_read_strobe  : in  std_logic;
@@ -21,13 +23,16 @@ entity chu_mcs_bridge is
       fp_rd           : out std_logic;
       fp_addr         : out std_logic_vector(20 downto 0);
       fp_wr_data      : out std_logic_vector(31 downto 0);
-      fp_rd_data      : in  std_logic_vector(31 downto 0)
+      fp_rd_data      : in  std_logic_vector(31 downto 0);
+      -- '0': the selected core cannot take the access in this clock
+      fp_ready        : in  std_logic := '1'
    );
 end chu_mcs_bridge;
 
 architecture arch of chu_mcs_bridge is
    signal mcs_bridge_en : std_logic;
    signal word_addr     : std_logic_vector(29 downto 0);
+   signal rd_req, wr_req, rd_pend, wr_pend, video_en : std_logic;
 begin
    -- address translation and decoding
    -- 2 LSBs are "00" due to word alignment
@@ -40,9 +45,29 @@ begin
       '1' when mcs_bridge_en='1' and io_address(23)='0' else '0';
    fp_addr       <= word_addr(20 downto 0);
    -- control line conversion 
-   fp_wr         <= io_write_strobe;
-   fp_rd         <= io_read_strobe;
-   io_ready      <= '1'; -- not used; transaction done in 1 clock
+   -- a strobe waits in rd_pend/wr_pend while fp_ready is '0' (the MCS holds
+   -- the address and write data until io_ready), then goes out for 1 clock
+   rd_req        <= io_read_strobe or rd_pend;
+   wr_req        <= io_write_strobe or wr_pend;
+   fp_wr         <= wr_req and fp_ready;
+   fp_rd         <= rd_req and fp_ready;
+   process(clk, reset)
+   begin
+      if reset = '1' then
+         rd_pend <= '0';
+         wr_pend <= '0';
+      elsif (clk'event and clk = '1') then
+         rd_pend <= rd_req and not fp_ready;
+         wr_pend <= wr_req and not fp_ready;
+      end if;
+   end process;
+   -- transaction done in the clock of fp_rd/fp_wr, the MCS samples
+   -- io_read_data there; a video read (sorting core memory window,
+   -- synchronous BRAM read) has its data one clock later, so it waits for
+   -- one more clock
+   video_en      <= '1' when mcs_bridge_en='1' and io_address(23)='1' else '0';
+   io_ready      <= '0' when (rd_req='1' or wr_req='1') and fp_ready='0' else
+                    '0' when video_en='1' and rd_req='1' else '1';
    -- data line conversion
    fp_wr_data    <= io_write_data;
    io_read_data  <= fp_rd_data;
@@ -75,7 +75,8 @@ architecture arch of mcs_top_sampler_basys3 is
          io_byte_enable  : out std_logic_vector(3 downto 0);
          io_write_data   : out std_logic_vector(31 downto 0);
          io_read_data    : in  std_logic_vector(31 downto 0);
-         io_ready        : in  std_logic
+         io_ready        : in  std_logic;
+         intc_interrupt  : in  std_logic_vector(1 downto 0)
       );
    end component;
    signal io_addr_strobe  : std_logic;
@@ -92,6 +93,10 @@ architecture arch of mcs_top_sampler_basys3 is
    signal mmio_addr       : std_logic_vector(20 downto 0);
    signal mmio_wr_data    : std_logic_vector(31 downto 0);
    signal mmio_rd_data    : std_logic_vector(31 downto 0);
+   signal video_cs        : std_logic;
+   signal video_rd_data   : std_logic_vector(31 downto 0);
+   signal fp_rd_data      : std_logic_vector(31 downto 0);
+   signal fp_ready        : std_logic;
    -- clk/reset related
    signal clk_100M        : std_logic;
    signal reset_sys       : std_logic;
@@ -108,6 +113,10 @@ architecture arch of mcs_top_sampler_basys3 is
    signal acl_ss_n    : std_logic;
    signal tmp_i2c_scl : std_logic;
    signal tmp_i2c_sda : std_logic;
+   -- external interrupt 0 of the MCS: sorting core Done
+   signal sort_irq    : std_logic;
+   -- external interrupt 1 of the MCS: uart1 tx fifo empty
+   signal uart_irq    : std_logic;
    
    
 begin
@@ -155,12 +164,16 @@ begin
          io_address      => io_address,
          io_write_data   => io_write_data,
          io_read_data    => io_read_data,
-         io_ready        => io_ready
+         io_ready        => io_ready,
+         intc_interrupt(0) => sort_irq,
+         intc_interrupt(1) => uart_irq
       );
    -- instantiate MCS IO bus to FPro bus bridge
    bridge_unit : entity work.chu_mcs_bridge
       generic map(BRG_BASE => BRIDGE_BASE)
       port map(
+         clk             => clk_100M,
+         reset           => reset_sys,
          io_addr_strobe  => io_addr_strobe,
          io_read_strobe  => io_read_strobe,
          io_write_strobe => io_write_strobe,
@@ -169,14 +182,17 @@ begin
          io_write_data   => io_write_data,
          io_read_data    => io_read_data,
          io_ready        => io_ready,
-         fp_video_cs     => open,
+         fp_video_cs     => video_cs,
          fp_mmio_cs      => mmio_cs,
          fp_wr           => mmio_wr,
          fp_rd           => mmio_rd,
          fp_addr         => mmio_addr,
          fp_wr_data      => mmio_wr_data,
-         fp_rd_data      => mmio_rd_data
+         fp_rd_data      => fp_rd_data,
+         fp_ready        => fp_ready
       );
+   -- video space: only the memory window of the sorting core
+   fp_rd_data <= video_rd_data when video_cs = '1' else mmio_rd_data;
    -- instantiate sampler MMIO subsystem 
    mmio_sys_unit : entity work.mmio_sys_sampler_basys3
       port map(
@@ -188,6 +204,9 @@ begin
          mmio_addr    => mmio_addr,
          mmio_wr_data => mmio_wr_data,
          mmio_rd_data => mmio_rd_data,
+         video_cs     => video_cs,
+         video_rd_data=> video_rd_data,
+         mmio_ready   => fp_ready,
          sw           => sw,
          led          => led,
          rx           => rx,
@@ -207,7 +226,9 @@ begin
          ps2d         => ps2d,
          ps2c         => ps2c,
          ddfs_sq_wave => ddfs_sq_wave,
-         pdm          => pdm
+         pdm          => pdm,
+         sort_irq     => sort_irq,
+         uart_irq     => uart_irq
       );
 end arch;
 
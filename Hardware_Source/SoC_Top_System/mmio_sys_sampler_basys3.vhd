@@ -18,6 +18,11 @@ entity mmio_sys_sampler_basys3 is
       mmio_addr    : in    std_logic_vector(20 downto 0); 
       mmio_wr_data : in    std_logic_vector(31 downto 0);
       mmio_rd_data : out   std_logic_vector(31 downto 0);
+      -- video address space (sorting core memory window)
+      video_cs     : in    std_logic;
+      video_rd_data: out   std_logic_vector(31 downto 0);
+      -- bus wait of the sorting core (bridge fp_ready)
+      mmio_ready   : out   std_logic;
       -- switches and LEDs
       sw           : in    std_logic_vector(15 downto 0);
       led          : out   std_logic_vector(15 downto 0);
@@ -48,7 +53,11 @@ entity mmio_sys_sampler_basys3 is
       --ddfs square wave output
       ddfs_sq_wave : out   std_logic;
       -- 1-bit dac 
-      pdm          : out   std_logic
+      pdm          : out   std_logic;
+      -- sorting core Done interrupt
+      sort_irq     : out   std_logic;
+      -- uart1 tx fifo empty interrupt
+      uart_irq     : out   std_logic
    );
 end mmio_sys_sampler_basys3;
 
@@ -60,12 +69,18 @@ architecture arch of mmio_sys_sampler_basys3 is
    signal rd_data_array  : slot_2d_data_type;
    signal wr_data_array  : slot_2d_data_type;
    signal adsr_env       : std_logic_vector(15 downto 0);
+   signal sort_win_cs    : std_logic;
+   signal sort_phase     : std_logic_vector(5 downto 0);
 begin
    --******************************************************************
    --  MMIO controller instantiation  
    --******************************************************************
+   -- slot 14 (S14_BUS_MON): per-slot read/write counters of the controller
    ctrl_unit : entity work.chu_mmio_controller
+      generic map(MON_SLOT => S14_BUS_MON, MON_SLOTS => 16)
       port map(
+         clk                 => clk,
+         reset               => reset,
          -- FPro bus interface
          mmio_cs             => mmio_cs,
          mmio_wr             => mmio_wr,
@@ -73,6 +88,7 @@ begin
          mmio_addr           => mmio_addr,
          mmio_wr_data        => mmio_wr_data,
          mmio_rd_data        => mmio_rd_data,
+         video_cs            => video_cs,
          -- 64 slot interface
          slot_cs_array       => cs_array,
          slot_reg_addr_array => reg_addr_array,
@@ -94,7 +110,9 @@ begin
          write   => mem_wr_array(S0_SYS_TIMER),
          addr    => reg_addr_array(S0_SYS_TIMER),
          rd_data => rd_data_array(S0_SYS_TIMER),
-         wr_data => wr_data_array(S0_SYS_TIMER)
+         wr_data => wr_data_array(S0_SYS_TIMER),
+         -- load/sort/readback boundaries of the sorting core (slot 4)
+         cap     => sort_phase
       );
    -- slot 1: uart1     
    uart1_slot1 : entity work.chu_uart
@@ -110,7 +128,8 @@ begin
          wr_data => wr_data_array(S1_UART1),
          -- external signals
          tx      => tx,
-         rx      => rx
+         rx      => rx,
+         tx_irq  => uart_irq
       );
    -- slot 2: GPO for 16 LEDs
    gpo_slot2 : entity work.chu_gpo
@@ -143,7 +162,14 @@ begin
          din     => sw
       );
    -- slot 4: reserved for user defined              
+   -- NET_LANES => 16 selects the bitonic sorting network (N=8192 in ~0.47 ms)
+   -- SEL_LANES => 2/4/8 compares that many elements per clock in the selection sort
+   -- KEY_WIDTH => 8..20 fits next to the 128 KB MCS memory; INDEX => true (permutation
+   --   readback) needs a 64 KB MCS memory and BRAM_BUDGET => 34, up to KEY_WIDTH => 24
+   -- RADIX_BITS => 8/4: digit of ALG_RADIX (2 or 4 passes for 16-bit keys)
    user_slot4 : entity work.chu_sorting_core
+    generic map(NET_LANES => 0, SEL_LANES => 1, KEY_WIDTH => 16, INDEX => false, RADIX_BITS => 8,
+                HOST_BANK => false, BRAM_BUDGET => 18)
     port map(
        clk      => clk,
        reset    => reset,
@@ -152,8 +178,16 @@ begin
        write    => mem_wr_array(S4_USER),
        addr     => reg_addr_array(S4_USER),
        rd_data  => rd_data_array(S4_USER),
-       wr_data  => wr_data_array(S4_USER)
+       wr_data  => wr_data_array(S4_USER),
+       win_cs      => sort_win_cs,
+       win_addr    => mmio_addr(12 downto 0),
+       win_rd_data => video_rd_data,
+       phase    => sort_phase,
+       ready    => mmio_ready,
+       irq      => sort_irq
     );
+   -- memory window of the sorting core: video slot 4 (V4_USER4), word k = MEM[k]
+   sort_win_cs <= '1' when video_cs = '1' and mmio_addr(16 downto 14) = "100" else '0';
    --rd_data_array(4) <= (others => '0');
    -- slot 5: xadc           
    xadc_slot5 : entity work.chu_xadc_basys3_core
@@ -1,11 +1,22 @@
 --  Reg map;
 --    * 00: read (32 LSB of counter)
 --    * 01: read (16 MSB of counter)
+--    * 00011: read (16 MSB of counter latched by the last read of 00; a
+--      read of 00 then 00011 is tear-free)
 --    * 10: control register: 
 --        bit 0: go/pause
 --        bit 1: clear (no memory, just used to generate a 1-clock pulse)
+--    * 00100+2n: read (32 LSB of capture register n, n = 0..5)
+--    * 00101+2n: read (16 MSB of capture register n)
+--    * 10000: read (32 LSB of the free-running counter)
+--    * 10001: read (16 MSB of the free-running counter latched by the
+--      last read of 10000)
 --
 --  * 48-bit counter (up to 32 days)
+--  * capture register n loads the counter on a cap(n) pulse (the last
+--    pulse wins), clear resets it to 0 (no pulse since the clear)
+--  * 48-bit free-running counter: counts every clock from reset, not
+--    affected by go/pause or clear (time base of the software profiler)
 
 library ieee;
 use ieee.std_logic_1164.all;
@@ -20,7 +31,9 @@ entity chu_timer is
       read    : in  std_logic;
       addr    : in  std_logic_vector(4 downto 0);
       rd_data : out std_logic_vector(31 downto 0);
-      wr_data : in  std_logic_vector(31 downto 0)
+      wr_data : in  std_logic_vector(31 downto 0);
+      -- capture strobes
+      cap     : in  std_logic_vector(5 downto 0) := (others => '0')
    );
 end chu_timer;
 
@@ -30,6 +43,12 @@ architecture arch of chu_timer is
    signal ctrl_reg   : std_logic;
    signal wr_en      : std_logic;
    signal clear, go  : std_logic;
+   type cap_array_type is array (0 to 5) of unsigned(47 downto 0);
+   signal cap_reg    : cap_array_type;
+   signal rd_count   : unsigned(47 downto 0);
+   signal snap_reg   : unsigned(15 downto 0);
+   signal free_reg   : unsigned(47 downto 0);
+   signal free_snap  : unsigned(15 downto 0);
 begin
    --******************************************************************
    -- counter
@@ -48,6 +67,54 @@ begin
                  count_reg + 1   when go = '1' else
                  count_reg;
 
+   --******************************************************************
+   -- snapshot of the 16 MSB, latched with the read of the 32 LSB
+   --******************************************************************
+   process(clk, reset)
+   begin
+      if reset = '1' then
+         snap_reg <= (others => '0');
+      elsif (clk'event and clk = '1') then
+         if read = '1' and cs = '1' and addr = "00000" then
+            snap_reg <= count_reg(47 downto 32);
+         end if;
+      end if;
+   end process;
+
+   --******************************************************************
+   -- free-running counter and snapshot of its 16 MSB
+   --******************************************************************
+   process(clk, reset)
+   begin
+      if reset = '1' then
+         free_reg <= (others => '0');
+         free_snap <= (others => '0');
+      elsif (clk'event and clk = '1') then
+         free_reg <= free_reg + 1;
+         if read = '1' and cs = '1' and addr = "10000" then
+            free_snap <= free_reg(47 downto 32);
+         end if;
+      end if;
+   end process;
+
+   --******************************************************************
+   -- capture registers
+   --******************************************************************
+   process(clk, reset)
+   begin
+      if reset = '1' then
+         cap_reg <= (others => (others => '0'));
+      elsif (clk'event and clk = '1') then
+         for i in 0 to 5 loop
+            if clear = '1' then
+               cap_reg(i) <= (others => '0');
+            elsif cap(i) = '1' then
+               cap_reg(i) <= count_reg;
+            end if;
+         end loop;
+      end if;
+   end process;
+
    --******************************************************************
    -- wrapping circuit
    --******************************************************************
@@ -68,7 +135,18 @@ begin
    clear <= '1' when wr_en='1' and wr_data(1)='1' else '0';
    go    <= ctrl_reg;
    -- slot read multiplexing
+   with addr(4 downto 1) select
+      rd_count <= cap_reg(0) when "0010",
+                  cap_reg(1) when "0011",
+                  cap_reg(2) when "0100",
+                  cap_reg(3) when "0101",
+                  cap_reg(4) when "0110",
+                  cap_reg(5) when "0111",
+                  free_reg   when "1000",
+                  count_reg  when others;
    rd_data <= 
-      std_logic_vector(count_reg(31 downto 0)) when addr(0)='0' else 
-      x"0000" & std_logic_vector(count_reg(47 downto 32));
+      x"0000" & std_logic_vector(snap_reg) when addr="00011" else
+      x"0000" & std_logic_vector(free_snap) when addr="10001" else
+      std_logic_vector(rd_count(31 downto 0)) when addr(0)='0' else 
+      x"0000" & std_logic_vector(rd_count(47 downto 32));
 end arch;
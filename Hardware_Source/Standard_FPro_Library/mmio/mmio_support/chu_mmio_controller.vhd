@@ -1,9 +1,35 @@
+--  Bus monitor: the controller answers slot MON_SLOT itself (the slot
+--  rd_data of that slot is ignored) with per-slot transaction counters
+--  for slots 0 .. MON_SLOTS-1, one pair for the video address space
+--  (video_cs, e.g. the sorting core memory window) and a cycle counter.
+--  Reg map of the monitor slot:
+--    * 00000: write: bit 0 clear all counters (1-clock pulse),
+--             bit 1 freeze (1: nothing counts, for a consistent readout)
+--             read: MON_SLOTS
+--    * 00001: write: bit 0 selects the counters of 10000+n (0 reads, 1 writes)
+--    * 00010: read (32 LSB of the cycle counter, latches the 16 MSB)
+--    * 00011: read (16 MSB latched by the read of 00010)
+--    * 00100: read (read or write accesses of the video space, 32 bits)
+--    * 10000+n: read (read or write accesses of slot n, 32 bits, wraps)
+--  Every clock with mmio_cs (or video_cs) and mmio_rd/mmio_wr is one access;
+--  chu_mcs_bridge raises mmio_rd/mmio_wr for exactly one clock per MCS
+--  access, also when fp_ready holds it. The accesses to the monitor slot
+--  count too, except while frozen: the freeze write counts, the unfreeze
+--  write does not (BusMonitor::delta() takes the freeze write out).
+--  Testbench: My_Custom_IP/src_sim/tb_chu_mmio_controller.vhd
+
 library ieee;
 use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
 use work.chu_io_map.all;
 entity chu_mmio_controller is
+   generic(
+      MON_SLOT  : integer := 14;
+      MON_SLOTS : integer := 16  -- slots with counters, 1..16
+   );
    port(
+      clk                 : in  std_logic := '0';
+      reset               : in  std_logic := '0';
       -- FPro bus 
       mmio_cs             : in  std_logic;
       mmio_wr             : in  std_logic;
@@ -11,6 +37,8 @@ entity chu_mmio_controller is
       mmio_addr           : in  std_logic_vector(20 downto 0);
       mmio_wr_data        : in  std_logic_vector(31 downto 0);
       mmio_rd_data        : out std_logic_vector(31 downto 0);
+      -- video space select of the bridge (counted by the monitor only)
+      video_cs            : in  std_logic := '0';
       -- slot interface
       slot_cs_array       : out std_logic_vector(63 downto 0);
       slot_mem_rd_array   : out std_logic_vector(63 downto 0);
@@ -27,6 +55,16 @@ architecture arch of chu_mmio_controller is
          mmio_addr(10 downto 5);
    alias reg_addr  : std_logic_vector(4 downto 0) is 
          mmio_addr(4 downto 0);
+   type count_array_type is array (0 to MON_SLOTS-1) of unsigned(31 downto 0);
+   signal rd_count, wr_count : count_array_type;
+   signal video_rd_count, video_wr_count : unsigned(31 downto 0);
+   signal cycle_reg  : unsigned(47 downto 0);
+   signal snap_reg   : unsigned(15 downto 0);
+   signal freeze, sel_wr : std_logic;
+   signal mon_cs, mon_wr, mon_rd : std_logic;
+   signal slot_n     : integer range 0 to 63;
+   signal reg_n      : integer range 0 to 15;
+   signal mon_rd_data : std_logic_vector(31 downto 0);
 begin
    -- address decoding
       process(slot_addr, mmio_cs)
@@ -42,6 +80,91 @@ begin
    slot_wr_data_array  <= (others => mmio_wr_data);
    slot_reg_addr_array <= (others => reg_addr);
    -- mux for read data 
-   mmio_rd_data <= slot_rd_data_array(to_integer(unsigned(slot_addr)));
+   mmio_rd_data <= mon_rd_data when mon_cs = '1' else
+                   slot_rd_data_array(to_integer(unsigned(slot_addr)));
+
+   --******************************************************************
+   -- bus monitor
+   --******************************************************************
+   slot_n <= to_integer(unsigned(slot_addr));
+   reg_n  <= to_integer(unsigned(reg_addr(3 downto 0)));
+   mon_cs <= '1' when mmio_cs = '1' and slot_n = MON_SLOT else '0';
+   mon_wr <= mon_cs and mmio_wr;
+   mon_rd <= mon_cs and mmio_rd;
+   process(clk, reset)
+   begin
+      if reset = '1' then
+         rd_count <= (others => (others => '0'));
+         wr_count <= (others => (others => '0'));
+         video_rd_count <= (others => '0');
+         video_wr_count <= (others => '0');
+         cycle_reg <= (others => '0');
+         snap_reg <= (others => '0');
+         freeze <= '0';
+         sel_wr <= '0';
+      elsif (clk'event and clk = '1') then
+         if freeze = '0' then
+            cycle_reg <= cycle_reg + 1;
+            if mmio_cs = '1' and slot_n < MON_SLOTS then
+               if mmio_rd = '1' then
+                  rd_count(slot_n) <= rd_count(slot_n) + 1;
+               end if;
+               if mmio_wr = '1' then
+                  wr_count(slot_n) <= wr_count(slot_n) + 1;
+               end if;
+            end if;
+            if video_cs = '1' then
+               if mmio_rd = '1' then
+                  video_rd_count <= video_rd_count + 1;
+               end if;
+               if mmio_wr = '1' then
+                  video_wr_count <= video_wr_count + 1;
+               end if;
+            end if;
+         end if;
+         if mon_wr = '1' and reg_addr = "00000" then
+            freeze <= mmio_wr_data(1);
+            if mmio_wr_data(0) = '1' then
+               rd_count <= (others => (others => '0'));
+               wr_count <= (others => (others => '0'));
+               video_rd_count <= (others => '0');
+               video_wr_count <= (others => '0');
+               cycle_reg <= (others => '0');
+            end if;
+         end if;
+         if mon_wr = '1' and reg_addr = "00001" then
+            sel_wr <= mmio_wr_data(0);
+         end if;
+         if mon_rd = '1' and reg_addr = "00010" then
+            snap_reg <= cycle_reg(47 downto 32);
+         end if;
+      end if;
+   end process;
+   process(reg_addr, reg_n, rd_count, wr_count, video_rd_count, video_wr_count,
+           sel_wr, cycle_reg, snap_reg)
+   begin
+      mon_rd_data <= (others => '0');
+      if reg_addr(4) = '1' then
+         if reg_n < MON_SLOTS then
+            if sel_wr = '1' then
+               mon_rd_data <= std_logic_vector(wr_count(reg_n));
+            else
+               mon_rd_data <= std_logic_vector(rd_count(reg_n));
+            end if;
+         end if;
+      elsif reg_addr = "00000" then
+         mon_rd_data <= std_logic_vector(to_unsigned(MON_SLOTS, 32));
+      elsif reg_addr = "00010" then
+         mon_rd_data <= std_logic_vector(cycle_reg(31 downto 0));
+      elsif reg_addr = "00011" then
+         mon_rd_data <= x"0000" & std_logic_vector(snap_reg);
+      elsif reg_addr = "00100" then
+         if sel_wr = '1' then
+            mon_rd_data <= std_logic_vector(video_wr_count);
+         else
+            mon_rd_data <= std_logic_vector(video_rd_count);
+         end if;
+      end if;
+   end process;
 end arch;
 
@@ -17,7 +17,9 @@ entity chu_uart is
       wr_data : in  std_logic_vector(31 downto 0);
       -- external signals
       tx      : out std_logic;
-      rx      : in  std_logic
+      rx      : in  std_logic;
+      -- tx fifo empty and interrupt enabled (buffered logging)
+      tx_irq  : out std_logic
    );
 end chu_uart;
 
@@ -26,7 +28,10 @@ architecture arch of chu_uart is
    signal wr_uart  : std_logic;
    signal rd_uart  : std_logic;
    signal wr_dvsr  : std_logic;
+   signal wr_ctrl  : std_logic;
    signal tx_full  : std_logic;
+   signal tx_empty : std_logic;
+   signal ie_reg   : std_logic;
    signal rx_empty : std_logic;
    signal r_data   : std_logic_vector(7 downto 0);
    signal dvsr_reg : std_logic_vector(10 downto 0);
@@ -49,7 +54,8 @@ begin
          w_data   => wr_data(7 downto 0),
          r_data   => r_data,
          tx_full  => tx_full,
-         rx_empty => rx_empty
+         rx_empty => rx_empty,
+         tx_empty => tx_empty
       );
    -- baud rate register
    process(clk, reset)
@@ -62,11 +68,24 @@ begin
          end if;
       end if;
    end process;
+   -- tx interrupt enable register (bit 0 of reg 4)
+   process(clk, reset)
+   begin
+      if (reset = '1') then
+         ie_reg <= '0';
+      elsif (clk'event and clk = '1') then
+         if wr_ctrl = '1' then
+            ie_reg <= wr_data(0);
+         end if;
+      end if;
+   end process;
+   tx_irq <= ie_reg and tx_empty;
    -- write decoding
    wr_en   <= '1' when write = '1' and cs = '1' else '0';
    wr_dvsr <= '1' when addr(1 downto 0)="01" and wr_en = '1' else '0';
    wr_uart <= '1' when addr(1 downto 0)="10" and wr_en = '1' else '0';
    rd_uart <= '1' when addr(1 downto 0)="11" and wr_en = '1' else '0';
+   wr_ctrl <= '1' when addr(2 downto 0)="100" and wr_en = '1' else '0';
    -- read multiplexing   
-   rd_data <= x"00000" & "00" & tx_full & rx_empty & r_data;
+   rd_data <= x"00000" & "0" & tx_empty & tx_full & rx_empty & r_data;
 end arch;
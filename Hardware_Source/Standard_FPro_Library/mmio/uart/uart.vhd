@@ -17,6 +17,7 @@ entity uart is
       w_data     : in  std_logic_vector(7 downto 0);
       tx_full    : out std_logic;
       rx_empty   : out std_logic;
+      tx_empty   : out std_logic;
       r_data     : out std_logic_vector(7 downto 0);
       tx         : out std_logic
    );
@@ -27,7 +28,7 @@ architecture str_arch of uart is
    signal rx_done_tick      : std_logic;
    signal tx_fifo_out       : std_logic_vector(7 downto 0);
    signal rx_data_out       : std_logic_vector(7 downto 0);
-   signal tx_empty          : std_logic;
+   signal tx_fifo_empty     : std_logic;
    signal tx_fifo_not_empty : std_logic;
    signal tx_done_tick      : std_logic;
 begin
@@ -77,9 +78,10 @@ begin
          rd     => tx_done_tick,
          wr     => wr_uart,
          w_data => w_data,
-         empty  => tx_empty,
+         empty  => tx_fifo_empty,
          full   => tx_full,
          r_data => tx_fifo_out
       );
-   tx_fifo_not_empty <= not tx_empty;
+   tx_fifo_not_empty <= not tx_fifo_empty;
+   tx_empty <= tx_fifo_empty;
 end str_arch;
\ No newline at end of file
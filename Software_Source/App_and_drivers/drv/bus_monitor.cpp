@@ -0,0 +1,89 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: bus_monitor.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Implements the BusMonitor class: frozen readout of the per-slot and
+ * video access counters, snapshot differences and the UART report.
+ * -----------------------------------------------------------------------------
+ */
+
+#include "bus_monitor.h"
+
+static const char *const sampler_names[BusMonitor::MAX_SLOTS] = {
+	"timer", "uart", "led", "sw", "sort", "xadc", "pwm", "btn",
+	"sseg", "spi", "i2c", "ps2", "ddfs", "adsr", "bus_mon", "slot15"
+};
+
+BusMonitor::BusMonitor(uint32_t core_base_addr) {
+	base_addr = core_base_addr;
+	n_slots = -1; // read on first use
+}
+BusMonitor::~BusMonitor() {
+}
+
+int BusMonitor::slots() {
+	if (n_slots < 0) {
+		n_slots = (int) io_read(base_addr, CTRL_REG);
+		if (n_slots > MAX_SLOTS) n_slots = MAX_SLOTS;
+	}
+	return n_slots;
+}
+
+void BusMonitor::clear() {
+	io_write(base_addr, CTRL_REG, CLR_BIT);
+}
+
+void BusMonitor::snapshot(Snapshot *s) {
+	int n = slots();
+	io_write(base_addr, CTRL_REG, FREEZE_BIT);
+	uint64_t lower = io_read(base_addr, CYCLE_LOWER_REG);
+	uint64_t upper = io_read(base_addr, CYCLE_UPPER_REG);
+	s->cycles = (upper << 32) | lower;
+	io_write(base_addr, SEL_REG, 0);
+	for (int i = 0; i < MAX_SLOTS; i++)
+		s->reads[i] = (i < n) ? io_read(base_addr, COUNT_REG + i) : 0;
+	s->video_reads = io_read(base_addr, VIDEO_REG);
+	io_write(base_addr, SEL_REG, SEL_WR_BIT);
+	for (int i = 0; i < MAX_SLOTS; i++)
+		s->writes[i] = (i < n) ? io_read(base_addr, COUNT_REG + i) : 0;
+	s->video_writes = io_read(base_addr, VIDEO_REG);
+	io_write(base_addr, CTRL_REG, 0);
+	s->mon = (base_addr >> 7) & 0x3f; // own slot, 32 words per slot
+}
+
+void BusMonitor::delta(const Snapshot *from, const Snapshot *to, Snapshot *d) {
+	d->cycles = to->cycles - from->cycles;
+	for (int i = 0; i < MAX_SLOTS; i++) {
+		d->reads[i] = to->reads[i] - from->reads[i]; // 32-bit wrap
+		d->writes[i] = to->writes[i] - from->writes[i];
+	}
+	d->video_reads = to->video_reads - from->video_reads;
+	d->video_writes = to->video_writes - from->video_writes;
+	d->mon = to->mon;
+	if (d->mon < MAX_SLOTS && d->writes[d->mon])
+		d->writes[d->mon]--; // the freeze write of to
+}
+
+void BusMonitor::report(UartCore *port, const Snapshot *d, const char *const *names) {
+	if (!names) names = sampler_names;
+	uint32_t video = d->video_reads + d->video_writes;
+	uint64_t total = video; // the slot counters may sum past 32 bits
+	for (int i = 0; i < MAX_SLOTS; i++)
+		total += d->reads[i] + d->writes[i];
+	port->disp("slot,name,reads,writes,share\r\n");
+	for (int i = 0; i < MAX_SLOTS; i++) {
+		uint32_t n = d->reads[i] + d->writes[i];
+		if (n == 0) continue;
+		port->disp(i); port->disp(","); port->disp(names[i]); port->disp(",");
+		port->disp_u64(d->reads[i]); port->disp(","); port->disp_u64(d->writes[i]); port->disp(",");
+		port->disp(100.0 * n / total, 1); port->disp("%\r\n");
+	}
+	if (video) {
+		port->disp("v,video,");
+		port->disp_u64(d->video_reads); port->disp(","); port->disp_u64(d->video_writes); port->disp(",");
+		port->disp(100.0 * video / total, 1); port->disp("%\r\n");
+	}
+	port->disp("accesses: "); port->disp_u64(total);
+	port->disp(" in "); port->disp_u64(d->cycles); port->disp(" cycles\r\n");
+}
@@ -0,0 +1,74 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: bus_monitor.h
+ * Author: Kainoa Asse
+ * Description:
+ * Driver for the bus monitor of chu_mmio_controller (slot S14_BUS_MON):
+ * read and write access counters per MMIO slot, one pair for the video
+ * space (the sorting core memory window) and a cycle counter.
+ * snapshot() takes all counters with counting frozen, delta() subtracts
+ * two snapshots and report() prints the busy slots over the UART, so a
+ * code section can be charged with its bus traffic per slot.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _BUS_MONITOR_H_INCLUDED
+#define _BUS_MONITOR_H_INCLUDED
+
+#include "chu_init.h"
+
+class BusMonitor {
+public:
+/* Register map */
+	enum {
+		CTRL_REG = 0, // write: clear, freeze; read: number of counted slots
+		SEL_REG = 1, // counters shown at COUNT_REG: reads (0) or writes (1)
+		CYCLE_LOWER_REG = 2, // lower 32 bits of the cycle counter (latches the upper 16)
+		CYCLE_UPPER_REG = 3, // upper 16 bits latched by the read of CYCLE_LOWER_REG
+		VIDEO_REG = 4, // accesses of the video space (all video slots)
+		COUNT_REG = 16 // COUNT_REG + n: accesses of slot n
+	};
+
+	/*masks*/
+	enum {
+		CLR_BIT = 0x00000001, //CTRL_REG: clear all counters
+		FREEZE_BIT = 0x00000002, //CTRL_REG: stop counting
+		SEL_WR_BIT = 0x00000001 //SEL_REG: write counters
+	};
+
+	enum {
+		MAX_SLOTS = 16
+	};
+
+	struct Snapshot {
+		uint64_t cycles;
+		uint32_t reads[MAX_SLOTS];
+		uint32_t writes[MAX_SLOTS];
+		uint32_t video_reads; // video space, e.g. SortCore::buffer()
+		uint32_t video_writes;
+		int mon; // slot of the monitor that took the snapshot
+	};
+
+	BusMonitor(uint32_t core_base_addr);
+	~BusMonitor(); // not used
+
+	int slots(); // slots with counters (0: no monitor in the controller)
+	void clear(); // all counters and the cycle counter to 0
+	/* all counters at one instant: counting is frozen while they are read,
+	   so the readout and the unfreeze write are not counted; the freeze
+	   write is (one write to the monitor slot) */
+	void snapshot(Snapshot *s);
+	/* d = to - from, without the freeze write of to: only the accesses
+	   between the two snapshots */
+	static void delta(const Snapshot *from, const Snapshot *to, Snapshot *d);
+	/* one line per slot with traffic: slot,name,reads,writes,% of the
+	   accesses, then a "v,video" line for the video space; names[n] of
+	   slot n, 0: the sampler slot names; printed on port */
+	void report(UartCore *port, const Snapshot *d, const char *const *names = 0);
+
+private:
+	uint32_t base_addr;
+	int n_slots;
+};
+
+#endif
@@ -50,13 +50,14 @@ extern "C" {
 #define S11_PS2      11
 #define S12_DDFS     12
 #define S13_ADSR     13
+#define S14_BUS_MON  14 // bus monitor of chu_mmio_controller (per-slot access counters)
 
 // video module definition
 #define V0_SYNC      0
 #define V1_MOUSE     1
 #define V2_OSD       2
 #define V3_GHOST     3
-#define V4_USER4     4
+#define V4_USER4     4 // sorting core memory window (word k = MEM[k])
 #define V5_USER5     5
 #define V6_GRAY      6
 #define V7_BAR       7
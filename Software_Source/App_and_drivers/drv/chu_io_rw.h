@@ -22,7 +22,14 @@ extern "C" {
  *  - must bypass data cache for I/O access
  *  - may be replaced with vendor provided macros
  *   (if _VENDOR_IO_ACCESS_USED is defined)
+ *  - _HOST_EMU build routes accesses to C++ device models on Linux
+ *   (see host/host_io.h)
  *********************************************************************/
+#ifdef _HOST_EMU
+#define _VENDOR_IO_ACCESS_USED
+#include "../host/host_io.h"
+#endif  // _HOST_EMU
+
 #ifndef _VENDOR_IO_ACCESS_USED
 
 /**
@@ -45,6 +52,14 @@ extern "C" {
 #define io_write(base_addr, offset, data) \
    (*(volatile uint32_t *)((base_addr) + 4*(offset)) = (data))
 
+/**
+ * pointer to a memory window of an io core (e.g., in a video slot)
+ * @param base_addr base address of the window
+ * @return pointer whose element k is the 32-bit word at base_addr + 4*k
+ */
+typedef volatile uint32_t *io_ptr_t;
+#define io_ptr(base_addr) ((io_ptr_t)(base_addr))
+
 #endif  // _VENDOR_IO_ACCESS_USED
 /**
  * calculate base address of a memory mapped io slot.
@@ -0,0 +1,57 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: mcs_intc.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Board implementation of mcs_intc.h on top of the BSP xiomodule driver.
+ * External interrupt n is IO module interrupt 16 + n. The IO module is
+ * started and MicroBlaze interrupts are enabled on first use.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _HOST_EMU
+
+#include "mcs_intc.h"
+#include "xparameters.h"
+#include "xiomodule.h"
+#include "mb_interface.h"
+
+static XIOModule iomodule;
+static bool started = false;
+static unsigned int enabled = 0; // lines enabled by intc_enable()
+
+static void intc_start() {
+	if (started) return;
+	started = true;
+	XIOModule_Initialize(&iomodule, XPAR_IOMODULE_0_DEVICE_ID);
+	XIOModule_Start(&iomodule);
+	microblaze_register_handler((XInterruptHandler) XIOModule_DeviceInterruptHandler,
+			(void *) XPAR_IOMODULE_0_DEVICE_ID);
+	microblaze_enable_interrupts();
+}
+
+void intc_attach(int irq, intc_handler_t handler, void *arg) {
+	intc_start();
+	XIOModule_Connect(&iomodule, XIN_IOMODULE_EXTERNAL_INTERRUPT_INTR + irq,
+			(XInterruptHandler) handler, arg);
+}
+
+void intc_enable(int irq) {
+	intc_start();
+	XIOModule_Enable(&iomodule, XIN_IOMODULE_EXTERNAL_INTERRUPT_INTR + irq);
+	enabled |= 1 << irq;
+}
+
+void intc_disable(int irq) {
+	XIOModule_Disable(&iomodule, XIN_IOMODULE_EXTERNAL_INTERRUPT_INTR + irq);
+	enabled &= ~(1 << irq);
+}
+
+int intc_enabled(int irq) {
+	return (enabled >> irq) & 1;
+}
+
+void intc_idle() {
+}
+
+#endif  // _HOST_EMU
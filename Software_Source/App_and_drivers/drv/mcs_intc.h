@@ -0,0 +1,48 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: mcs_intc.h
+ * Author: Kainoa Asse
+ * Description:
+ * External interrupt inputs (INTC_Interrupt) of the MicroBlaze MCS I/O
+ * module. On the board the handlers are dispatched by the xiomodule driver
+ * of the BSP; the _HOST_EMU build implements the same calls in host_io.cpp
+ * and delivers a model's interrupt after each MMIO access or in intc_idle().
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _MCS_INTC_H_INCLUDED
+#define _MCS_INTC_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* INTC_Interrupt lines (mcs_top_sampler_basys3) */
+#define INTC_SORT_IRQ 0 // chu_sorting_core Done (slot 4)
+#define INTC_UART_TX_IRQ 1 // chu_uart tx fifo empty (slot 1)
+
+typedef void (*intc_handler_t)(void *arg);
+
+/**
+ * connect a handler to an external interrupt line.
+ * @param irq line number (0..15)
+ * @param handler called in interrupt context; must clear the source
+ * @param arg passed to the handler
+ */
+void intc_attach(int irq, intc_handler_t handler, void *arg);
+void intc_enable(int irq);
+void intc_disable(int irq);
+int intc_enabled(int irq); // 1: the line is enabled (to restore it after a disable)
+
+/**
+ * wait for the next interrupt.
+ * @note board: returns immediately (handlers run between instructions);
+ *       host: runs the device models to their next interrupt
+ */
+void intc_idle();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif  // _MCS_INTC_H_INCLUDED
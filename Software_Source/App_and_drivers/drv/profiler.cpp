@@ -0,0 +1,78 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: profiler.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Implements the Profiler class: region table, per-region statistics and
+ * log2 histograms, and the UART dump.
+ * -----------------------------------------------------------------------------
+ */
+
+#include "profiler.h"
+
+Profiler::Profiler(TimerCore *timer) {
+	this->timer = timer;
+	n_regions = 0;
+	reset();
+}
+Profiler::~Profiler() {
+}
+
+int Profiler::region(const char *name) {
+	for (int i = 0; i < n_regions; i++) {
+		const char *a = regions[i].name, *b = name;
+		while (*a && *a == *b) {
+			a++;
+			b++;
+		}
+		if (*a == *b) return i;
+	}
+	if (n_regions == MAX_REGIONS) return -1;
+	regions[n_regions].name = name;
+	return n_regions++;
+}
+
+uint64_t Profiler::now() {
+	return timer->read_free_tick();
+}
+
+void Profiler::add(int id, uint64_t cycles) {
+	if (id < 0 || id >= n_regions) return;
+	Region *r = &regions[id];
+	if (r->count == 0 || cycles < r->min) r->min = cycles;
+	if (cycles > r->max) r->max = cycles;
+	r->sum += cycles;
+	r->count++;
+	int b = 0; // floor(log2(cycles)), 0 for 0 and 1
+	while (b < HIST_BINS - 1 && (cycles >> (b + 1)))
+		b++;
+	r->hist[b]++;
+}
+
+void Profiler::reset() {
+	for (int i = 0; i < MAX_REGIONS; i++) {
+		regions[i].count = 0;
+		regions[i].min = regions[i].max = regions[i].sum = 0;
+		for (int b = 0; b < HIST_BINS; b++)
+			regions[i].hist[b] = 0;
+	}
+}
+
+void Profiler::dump(UartCore *port) {
+	port->disp("region,count,min,avg,max,sum,log2 histogram (bin:count)\r\n");
+	for (int i = 0; i < n_regions; i++) {
+		Region *r = &regions[i];
+		if (r->count == 0) continue;
+		port->disp(r->name); port->disp(",");
+		port->disp((int)r->count); port->disp(",");
+		port->disp_u64(r->min); port->disp(",");
+		port->disp_u64(r->sum / r->count); port->disp(",");
+		port->disp_u64(r->max); port->disp(",");
+		port->disp_u64(r->sum); port->disp(",");
+		for (int b = 0; b < HIST_BINS; b++) {
+			if (!r->hist[b]) continue;
+			port->disp(" "); port->disp(b); port->disp(":"); port->disp((int)r->hist[b]);
+		}
+		port->disp("\r\n");
+	}
+}
@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: profiler.h
+ * Author: Kainoa Asse
+ * Description:
+ * Cycle profiler on the free-running counter of the system timer, which
+ * TimerCore::clear()/pause() do not touch, so a scope may enclose code
+ * timed with the main counter. Named regions collect count, min, max and
+ * sum of their durations and a log2 histogram (bin b: 2^b up to
+ * 2^(b+1)-1 clocks); a ProfileScope object times the block it lives in,
+ * add() records a duration measured elsewhere. dump() prints every region
+ * over the UART.
+ * A scope costs two MMIO reads at each end: keep scopes out of code whose
+ * cycles or bus traffic are measured, and add() those measurements after
+ * the measured section instead.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _PROFILER_H_INCLUDED
+#define _PROFILER_H_INCLUDED
+
+#include "timer_core.h"
+#include "uart_core.h"
+
+class Profiler {
+public:
+	enum {
+		MAX_REGIONS = 16, // named regions
+		HIST_BINS = 32 // log2 bins, the last one also counts longer samples
+	};
+
+	Profiler(TimerCore *timer);
+	~Profiler(); // not used
+
+	int region(const char *name); // id of the region, created on first use (-1: table full)
+	uint64_t now(); // free-running timer count (read_free_tick())
+	void add(int id, uint64_t cycles); // one sample of region id
+	void reset(); // clear the samples, keep the regions
+	/* one line per region with samples:
+	   name,count,min,avg,max,sum followed by bin:count of the histogram */
+	void dump(UartCore *port);
+
+private:
+	struct Region {
+		const char *name;
+		uint32_t count;
+		uint64_t min, max, sum;
+		uint32_t hist[HIST_BINS];
+	};
+	TimerCore *timer;
+	Region regions[MAX_REGIONS];
+	int n_regions;
+};
+
+/* times its own lifetime into a region of a Profiler */
+class ProfileScope {
+public:
+	ProfileScope(Profiler &prof, int id) : prof(prof), id(id) {
+		t0 = prof.now();
+	}
+	~ProfileScope() {
+		uint64_t t1 = prof.now();
+		prof.add(id, t1 - t0);
+	}
+
+private:
+	Profiler &prof;
+	int id;
+	uint64_t t0;
+};
+
+/* PROFILE_SCOPE(prof, "name"): time the rest of the enclosing block into
+   region "name" (looked up once per call site) */
+#define PROFILE_CAT2(a, b) a##b
+#define PROFILE_CAT(a, b) PROFILE_CAT2(a, b)
+#define PROFILE_SCOPE(prof, name) \
+	static int PROFILE_CAT(prof_id_, __LINE__) = (prof).region(name); \
+	ProfileScope PROFILE_CAT(prof_scope_, __LINE__)((prof), PROFILE_CAT(prof_id_, __LINE__))
+
+#endif
@@ -11,30 +11,57 @@
  
 #include "sorting_core.h"
 
-SortCore::SortCore(uint32_t core_base_addr) {
+SortCore::SortCore(uint32_t core_base_addr, uint32_t win_base_addr) {
 	base_addr = core_base_addr;
+	win_addr = win_base_addr;
 	wr_data = 0; // Initialize shadow register aka copy register
+	mode = 0; // selection sort
+	width = 16;
+	dbuf = false;
+	n_sorting = 0;
+	n_ready = 0;
+	n_set = RUN_SIZE;
+	heap = -1;
+	pending = false;
+	callback = 0;
+	callback_arg = 0;
+	irq_attached = false;
 }
 SortCore::~SortCore() {
 }
 
 void SortCore::set_n(uint16_t n){
+	n_set = (n % RUN_SIZE) ? n % RUN_SIZE : RUN_SIZE;
 	io_write(base_addr, N_REG, (uint32_t)n);
 }
 
+void SortCore::set_algorithm(int alg){
+	mode = ((uint32_t)alg << ALG_SHIFT) & ALG_MASK;
+	// latched by the core on the next CTRL_REG write
+	io_write(base_addr, CTRL_REG, mode);
+}
+
+void SortCore::set_width(int w){
+	width = w;
+}
+
+void SortCore::set_k(uint16_t k){
+	io_write(base_addr, K_REG, (uint32_t)k);
+}
+
 void SortCore::init_write(){
 	// Force IDLE to clear any previous sorting state
-	io_write(base_addr, CTRL_REG, 0);
+	io_write(base_addr, CTRL_REG, mode);
 	// rw=1, init=1, s=0 -> 0x06
-	io_write(base_addr, CTRL_REG, RW_BIT | INIT_BIT);
+	io_write(base_addr, CTRL_REG, mode | RW_BIT | INIT_BIT);
 }
 
 void SortCore::init_read(){
 	// Exit computation mode
-    io_write(base_addr, CTRL_REG, 0);
+    io_write(base_addr, CTRL_REG, mode);
 
     // Reset the internal pointer (ri = 0)
-    io_write(base_addr, CTRL_REG, INIT_BIT);
+    io_write(base_addr, CTRL_REG, mode | INIT_BIT);
 
     // Small wait to let the hardware state stabilize
     for(volatile int i=0; i<10; i++);
@@ -42,11 +69,11 @@ void SortCore::init_read(){
 }
 
 void SortCore::idle() {
-    io_write(base_addr, CTRL_REG, 0);
+    io_write(base_addr, CTRL_REG, mode);
 }
 
 void SortCore::sort(){
-	io_write(base_addr, CTRL_REG, S_BIT);
+	io_write(base_addr, CTRL_REG, mode | S_BIT);
 }
 	
 void SortCore::write(uint16_t data){
@@ -62,8 +89,353 @@ uint16_t SortCore::read(){
 	return (uint16_t)(io_read(base_addr, MEMR_ri_REG) & DATA_MASK);
 }
 
-	
+void SortCore::write_key(uint32_t key){
+	// the core keeps the low key_width() bits
+	io_write(base_addr, MEMW_ri_REG, key);
+}
+
+uint32_t SortCore::read_key(){
+	return io_read(base_addr, KEY_REG);
+}
+
+uint16_t SortCore::read_index(){
+	return (uint16_t)(io_read(base_addr, MEMRX_REG) & INDEX_MASK);
+}
+
+void SortCore::write_block(const uint16_t *data, int n){
+	int i = 0, np = n;
+	if (streaming()) np = 0; // one heap push per write
+	if (width <= 8) {
+		for (; i + 4 <= np; i += 4) {
+			io_write(base_addr, MEMW4_REG,
+					(uint32_t)(data[i] & 0xFF) | (uint32_t)(data[i + 1] & 0xFF) << 8 |
+					(uint32_t)(data[i + 2] & 0xFF) << 16 | (uint32_t)(data[i + 3] & 0xFF) << 24);
+		}
+	}
+	for (; i + 2 <= np; i += 2) {
+		io_write(base_addr, MEMW2_REG, (uint32_t)data[i] | (uint32_t)data[i + 1] << 16);
+	}
+	for (; i < n; i++) write(data[i]);
+}
+
+void SortCore::read_block(uint16_t *data, int n){
+	int i = 0, np = n;
+	uint32_t word;
+	if (sorted_on_load()) np = 0; // one heap pop / histogram step per read
+	if (width <= 8) {
+		for (; i + 4 <= np; i += 4) {
+			word = io_read(base_addr, MEMR4_REG);
+			data[i] = word & 0xFF;
+			data[i + 1] = (word >> 8) & 0xFF;
+			data[i + 2] = (word >> 16) & 0xFF;
+			data[i + 3] = word >> 24;
+		}
+	}
+	for (; i + 2 <= np; i += 2) {
+		word = io_read(base_addr, MEMR2_REG);
+		data[i] = word & DATA_MASK;
+		data[i + 1] = word >> 16;
+	}
+	for (; i < n; i++) data[i] = read();
+}
+
+bool SortCore::sort_index(const uint32_t *keys, int n, uint16_t *perm, uint32_t *sorted){
+	if (dbuf || !(io_read(base_addr, STATUS_REG) & IX_BIT) ||
+			((mode & ALG_MASK) >> ALG_SHIFT) == ALG_HIST) return false;
+	// ALG_SELECT only places MEM[K-1]: sort with ALG_RADIX for the call
+	bool sel = ((mode & ALG_MASK) >> ALG_SHIFT) == ALG_SELECT;
+	if (sel) set_algorithm(ALG_RADIX);
+	set_n(n);
+	init_write();
+	for (int i = 0; i < n; i++) write_key(keys[i]);
+	if (!streaming()) {
+		sort_async();
+		wait();
+	}
+	init_read();
+	for (int i = 0; i < n; i++) {
+		// KEY_REG leaves ri alone, MEMRX_REG advances it (and pops the heap)
+		if (sorted) sorted[i] = read_key();
+		perm[i] = read_index();
+	}
+	if (sel) set_algorithm(ALG_SELECT);
+	return true;
+}
+
+uint32_t SortCore::read_at(int i){
+	io_write(base_addr, ADDR_REG, (uint32_t)i);
+	return io_read(base_addr, DATA_REG);
+}
+
+void SortCore::write_at(int i, uint32_t v){
+	io_write(base_addr, ADDR_REG, (uint32_t)i);
+	io_write(base_addr, DATA_REG, v);
+}
+
+io_ptr_t SortCore::buffer(){
+	return io_ptr(win_addr);
+}
+
+void SortCore::generate(int n, int pattern, int w, uint16_t seed){
+	set_n(n);
+	io_write(base_addr, GEN_REG, (uint32_t)(pattern & 0x03) | (w <= 8 ? GEN_BYTE_BIT : 0) |
+			(uint32_t)seed << GEN_SEED_SHIFT);
+	while (io_read(base_addr, STATUS_REG) & GEN_BUSY_BIT);
+}
+
+bool SortCore::partial_sort(const uint16_t *data, int n, int k, uint16_t *out){
+	if (dbuf) return false;
+	if (k > n) k = n;
+	if (n < 2) {
+		// nothing to sort (the core would take N = 1 for a wrapped N-2 pass)
+		if (k > 0) out[0] = data[0];
+		return true;
+	}
+	// ALG_SELECT reads K as a rank and only places MEM[K-1]: use the
+	// selection sort for the call
+	bool sel = ((mode & ALG_MASK) >> ALG_SHIFT) == ALG_SELECT;
+	if (sel) set_algorithm(ALG_SELECTION);
+	set_n(n);
+	set_k(k);
+	init_write();
+	write_block(data, n);
+	if (!sorted_on_load()) {
+		sort_async();
+		wait();
+	}
+	init_read();
+	read_block(out, k);
+	set_k(0); // full sorts again
+	if (sel) set_algorithm(ALG_SELECT);
+	return true;
+}
+
+bool SortCore::select(const uint16_t *ranks, int n, uint32_t *out){
+	if (dbuf || sorted_on_load()) return false;
+	if (n <= 0) return true;
+	for (int i = 0; i < n; i++)
+		if (ranks[i] >= n_set) return false;
+	uint32_t saved = mode;
+	if (n == 1) {
+		set_algorithm(ALG_SELECT);
+		set_k(ranks[0] + 1); // the answer is left at MEM[K-1]
+	} else {
+		set_algorithm(ALG_RADIX);
+	}
+	sort_async();
+	wait();
+	idle();
+	for (int i = 0; i < n; i++)
+		out[i] = read_at(ranks[i]);
+	set_k(0);
+	set_algorithm((int)(saved >> ALG_SHIFT));
+	return true;
+}
+
+void SortCore::sort_async(void (*callback)(void *arg), void *arg){
+	if (!irq_attached) {
+		intc_attach(INTC_SORT_IRQ, done_isr, this);
+		intc_enable(INTC_SORT_IRQ);
+		irq_attached = true;
+	}
+	this->callback = callback;
+	callback_arg = arg;
+	pending = true;
+	io_write(base_addr, IRQ_REG, IE_BIT); // clear a stale flag, enable
+	sort();
+}
+
+void SortCore::wait(){
+	while (pending) intc_idle();
+}
+
+bool SortCore::busy(){
+	return pending;
+}
+
+void SortCore::done_isr(void *arg){
+	SortCore *core = (SortCore *) arg;
+	io_write(core->base_addr, IRQ_REG, 0); // disable and acknowledge
+	core->pending = false;
+	if (core->callback) core->callback(core->callback_arg);
+}
+
+bool SortCore::set_double_buffer(bool on){
+	dbuf = on && (io_read(base_addr, STATUS_REG) & HB_BIT);
+	io_write(base_addr, BANK_REG, dbuf ? DB_BIT : 0);
+	n_sorting = 0;
+	n_ready = 0;
+	return dbuf;
+}
+
+bool SortCore::submit(const uint16_t *data, int n){
+	if (n_ready) return false; // the host bank still holds a result
+	if (!dbuf || sorted_on_load()) {
+		// one batch at a time through the current bank (or the heap)
+		set_n(n);
+		init_write();
+		write_block(data, n);
+		if (!sorted_on_load()) {
+			sort_async();
+			wait();
+		}
+		n_ready = n;
+		return true;
+	}
+	// load the host bank; only init is written so s is left alone
+	io_write(base_addr, CTRL_REG, mode | RW_BIT | INIT_BIT);
+	write_block(data, n);
+	if (n_sorting) swap_result();
+	else {
+		idle();
+		io_write(base_addr, BANK_REG, DB_BIT | SWAP_BIT);
+	}
+	// the batch just loaded is now in the current bank; Done raises
+	// INTC_SORT_IRQ, swap_result() waits for it
+	set_n(n);
+	sort_async();
+	n_sorting = n;
+	return true;
+}
+
+int SortCore::collect(uint16_t *data){
+	int n;
+	if (!n_ready) {
+		if (!dbuf || !n_sorting) return 0;
+		swap_result();
+	}
+	if (dbuf && !sorted_on_load()) io_write(base_addr, CTRL_REG, mode | INIT_BIT);
+	else init_read();
+	read_block(data, n_ready);
+	n = n_ready;
+	n_ready = 0;
+	return n;
+}
+
+void SortCore::sort_external(uint16_t *data, uint32_t n, uint16_t *tmp){
+	uint32_t runs = (n + RUN_SIZE - 1) / RUN_SIZE;
+	uint32_t in = 0, out = 0;
+	bool db_old = dbuf;
+	uint32_t saved = mode;
+	uint16_t *src = tmp, *dst = data;
+
+	// runs of data[] -> sorted runs in tmp[]; the next run is loaded while
+	// the core sorts the current one. Every run is fully sorted by
+	// ALG_RADIX whatever algorithm (or K) was selected.
+	set_algorithm(ALG_RADIX);
+	set_k(0);
+	set_double_buffer(true);
+	while (in < runs) {
+		if (submit(data + in * RUN_SIZE, (int)run_len(n, in, RUN_SIZE))) in++;
+		else collect(tmp + (out++) * RUN_SIZE);
+	}
+	while (out < runs) collect(tmp + (out++) * RUN_SIZE);
+	set_double_buffer(db_old);
+	set_algorithm((int)(saved >> ALG_SHIFT));
+
+	// merge passes between tmp[] and data[], MAX_RUNS runs at a time
+	for (uint32_t len = RUN_SIZE; runs > 1; len *= MAX_RUNS) {
+		uint32_t groups = (runs + MAX_RUNS - 1) / MAX_RUNS;
+		for (uint32_t g = 0; g < groups; g++) {
+			uint32_t first = g * MAX_RUNS;
+			int k = (runs - first < MAX_RUNS) ? (int)(runs - first) : MAX_RUNS;
+			merge_runs(src, dst, n, first, k, len);
+		}
+		runs = groups;
+		uint16_t *t = src;
+		src = dst;
+		dst = t;
+	}
+	// odd number of passes (or a single run): result is in tmp[]
+	if (src != data)
+		for (uint32_t i = 0; i < n; i++) data[i] = src[i];
+}
+
+uint32_t SortCore::run_len(uint32_t n, uint32_t r, uint32_t len){
+	uint32_t start = r * len;
+	return (n - start < len) ? n - start : len;
+}
+
+// k-way merge of runs first .. first+k-1 (len elements each, the last
+// one possibly shorter) from src[] into dst[] at the same offset.
+// tree[1..k-1] hold the loser of each match, tree[0] the overall winner;
+// an exhausted run plays with key EMPTY_KEY (above any 16-bit value).
+void SortCore::merge_runs(const uint16_t *src, uint16_t *dst, uint32_t n,
+		uint32_t first, int k, uint32_t len){
+	static const uint32_t EMPTY_KEY = 0x10000;
+	uint32_t pos[MAX_RUNS], end[MAX_RUNS], key[MAX_RUNS];
+	int tree[MAX_RUNS];
+	uint32_t base = first * len, total = 0;
+	int leaves = 1;
+
+	while (leaves < k) leaves *= 2;
+	for (int r = 0; r < k; r++) {
+		pos[r] = base + r * len;
+		end[r] = pos[r] + run_len(n - base, r, len);
+		key[r] = src[pos[r]];
+		total += end[r] - pos[r];
+	}
+	// initial tournament, bottom up; missing leaves (r >= k) never win
+	int win[2 * MAX_RUNS];
+	for (int l = 0; l < leaves; l++) win[leaves + l] = l;
+	for (int t = leaves - 1; t >= 1; t--) {
+		int a = win[2 * t], b = win[2 * t + 1];
+		bool a_wins = (b >= k) || (a < k && key[a] <= key[b]);
+		win[t] = a_wins ? a : b;
+		tree[t] = a_wins ? b : a;
+	}
+	tree[0] = win[1];
+
+	for (uint32_t i = 0; i < total; i++) {
+		int w = tree[0];
+		dst[base + i] = (uint16_t)key[w];
+		key[w] = (++pos[w] < end[w]) ? src[pos[w]] : EMPTY_KEY;
+		// replay the matches on the path of the winner
+		for (int t = (w + leaves) / 2; t >= 1; t /= 2) {
+			int l = tree[t];
+			if (l < k && (key[l] < key[w] || (key[l] == key[w] && l < w))) {
+				tree[t] = w;
+				w = l;
+			}
+		}
+		tree[0] = w;
+	}
+}
+
+void SortCore::swap_result(){
+	wait(); // no STATUS_REG polling, the next batch is loaded meanwhile
+	idle(); // s=0
+	io_write(base_addr, BANK_REG, DB_BIT | SWAP_BIT);
+	n_ready = n_sorting;
+	n_sorting = 0;
+}
+
+bool SortCore::streaming(){
+	if (((mode & ALG_MASK) >> ALG_SHIFT) != ALG_STREAM) return false;
+	if (heap < 0) heap = (io_read(base_addr, STATUS_REG) & SH_BIT) ? 1 : 0;
+	return heap; // without the heap the engine sorts ALG_STREAM after the load
+}
+
+bool SortCore::sorted_on_load(){
+	return streaming() || ((mode & ALG_MASK) >> ALG_SHIFT) == ALG_HIST;
+}
+
+void SortCore::read_histogram(uint16_t *hist){
+	init_read(); // ri = 0
+	for (int b = 0; b < 256; b++) hist[b] = (uint16_t)io_read(base_addr, HIST_REG);
+	init_read();
+}
+
 bool SortCore::done(){
 	// Read bit 0 of status register
 	return (bool)(io_read(base_addr, STATUS_REG) & 0x01);
 }
+
+bool SortCore::verify(){
+	uint32_t st = io_read(base_addr, STATUS_REG);
+	return (st & SORTED_BIT) && (st & CHECK_BIT);
+}
+
+int SortCore::key_width(){
+	return (int)((io_read(base_addr, STATUS_REG) & KW_MASK) >> KW_SHIFT);
+}
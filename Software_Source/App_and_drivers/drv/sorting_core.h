@@ -12,6 +12,7 @@
 #define _SORTING_CORE_H_INCLUDED
 
 #include "chu_init.h"
+#include "mcs_intc.h"
  
 class SortCore {
 public:
@@ -20,8 +21,21 @@ public:
 		MEMW_ri_REG = 0, // Writing to MEM[ri] & ri++ (16 bits)
 		MEMR_ri_REG = 1, // Reading from MEM[ri] & ri++ (16 bits)
 		N_REG       = 2, // set N (16 bits)
-	    CTRL_REG    = 3, // control register rw, init, s
-		STATUS_REG  = 4 // Done (1-bit) register
+	    CTRL_REG    = 3, // control register alg, rw, init, s
+		STATUS_REG  = 4, // Done (1-bit) register
+		MEMW2_REG   = 5, // Writing two 16-bit values to MEM[ri], MEM[ri+1] & ri+=2
+		MEMR2_REG   = 6, // Reading MEM[ri+1] & MEM[ri] & ri+=2
+		MEMW4_REG   = 7, // Writing four 8-bit values to MEM[ri..ri+3] & ri+=4
+		MEMR4_REG   = 8, // Reading the low bytes of MEM[ri+3] .. MEM[ri] & ri+=4
+		BANK_REG    = 9, // host bank mode (db) and host/current bank swap
+		IRQ_REG     = 10, // Done interrupt enable; a write clears the pending flag
+		KEY_REG     = 11, // Reading the key of MEM[ri] (up to 32 bits), ri unchanged
+		MEMRX_REG   = 12, // Reading the index (load position) of MEM[ri] & ri++
+		HIST_REG    = 13, // Reading the histogram count of key byte ri & ri++
+		K_REG       = 14, // partial sort: stop once MEM[0..K-1] is sorted (0: all N)
+		GEN_REG     = 15, // fill MEM[0..N-1] from the on-core data generator
+		ADDR_REG    = 16, // random access: set/read ri
+		DATA_REG    = 17 // key of MEM[ri] (read) or MEM[ri] <= key (write), ri unchanged
 	};
 
 	/*masks*/
@@ -30,38 +44,209 @@ public:
 		S_BIT = 0x00000001, //mask for s bit 001
 		INIT_BIT = 0x00000002, //mask for init bit 010
 		RW_BIT = 0x00000004, //mask for RW bit 100
+		ALG_MASK = 0x00000038, //mask for algorithm select field (bits 5..3)
+		ALG_SHIFT = 3,
+		DB_BIT = 0x00000001, //BANK_REG: MEMW/MEMR use the host bank
+		SWAP_BIT = 0x00000002, //BANK_REG: exchange host and current bank (s=0 only)
+		HB_BIT = 0x00000002, //STATUS_REG: core has a host bank (NET_LANES = 0)
+		IE_BIT = 0x00000001, //IRQ_REG: Done interrupt enable
+		IRQ_BIT = 0x00000004, //STATUS_REG: Done interrupt pending
+		IX_BIT = 0x00000008, //STATUS_REG: elements carry an index (INDEX generic)
+		SORTED_BIT = 0x00000010, //STATUS_REG: keys read back since init_read are in order
+		CHECK_BIT = 0x00000020, //STATUS_REG: keys read back match the keys loaded (count, sum, XOR)
+		GEN_BUSY_BIT = 0x00000040, //STATUS_REG: data generator running
+		SH_BIT = 0x00000080, //STATUS_REG: core has the stream heap (NET_LANES = 0)
+		GEN_BYTE_BIT = 0x00000004, //GEN_REG: 8-bit data
+		GEN_SEED_SHIFT = 16, //GEN_REG: LFSR seed (0: 0xACE1)
+		KW_MASK = 0x00003F00, //STATUS_REG: key width in bits (KEY_WIDTH generic)
+		KW_SHIFT = 8,
+		INDEX_MASK = 0x00001FFF //13-bit element index
+	};
+
+	/* data generator patterns (GEN_REG bits 1..0) */
+	enum {
+		GEN_LFSR = 0, // 16-bit LFSR, taps 0, 2, 3, 5 (LFSR class of project_main.cpp)
+		GEN_DESC = 1, // N-1-i
+		GEN_ASC = 2, // i
+		GEN_FEW = 3 // LFSR & 3, four distinct values
+	};
+
+	/* phase strobes to the system timer capture registers
+	   (TimerCore::read_capture(n), cleared by TimerCore::clear()) */
+	enum {
+		CAP_LOAD_START = 0, // init_write() or generate()
+		CAP_LOAD_END = 1, // last element written
+		CAP_SORT_START = 2, // sort() / sort_async()
+		CAP_SORT_DONE = 3, // Done
+		CAP_READ_START = 4, // init_read()
+		CAP_READ_END = 5 // last element read back
+	};
+
+	/* external sort */
+	enum {
+		RUN_SIZE = 8192, // elements per hardware run (core memory, 2^13 words)
+		MAX_RUNS = 64 // runs per merge pass (loser tree leaves)
+	};
+
+	/* algorithms (CTRL_REG alg field) */
+	enum {
+		ALG_SELECTION = 0, // selection sort, ~N^2/2 clocks, one swap per outer iteration
+		ALG_MERGE = 1, // bottom-up merge sort over two BRAM banks, ~N log2 N clocks
+		ALG_STREAM = 2, // write() pushes into a pipelined heap, read() pops the smallest
+		ALG_HIST = 3, // counting sort of 8-bit keys from the load histogram, no sort phase
+		ALG_RADIX = 4, // LSD radix sort over two BRAM banks, ~2N clocks per digit (RADIX_BITS)
+		ALG_SELECT = 5 // MSD radix select: MEM[K-1] = K-th smallest (K_REG), ~2N clocks
 	};
 
 	/**
 	constructor: automatically called when an object of class SortCore is created
 	Note: Constructor has no return value, takes in parameter core_base_addr
-	to set initial attribute of base address
+	to set initial attribute of base address; win_base_addr: memory window
+	of the core (video slot V4_USER4), 0 if it is not wired
 	*/
-	SortCore(uint32_t core_base_addr);
+	SortCore(uint32_t core_base_addr, uint32_t win_base_addr = 0);
 	~SortCore(); // not used
 	
 	/* Methods*/
 	
 	/* Configuration */
 	void set_n(uint16_t n); // initialize N for loop control aka how many integers to sort
+	void set_algorithm(int alg); // ALG_SELECTION .. ALG_RADIX; sent with every CTRL_REG write
+	void set_width(int w); // data width in bits; w <= 8 packs four values per bus word in the block transfers
+	void set_k(uint16_t k); // partial sort of the selection sort engines, 0: full sort (default)
+	/* ALG_STREAM: init_write(), write() x N, init_read(), read() x N; the data is
+	   sorted while it is written, sort()/done() are not needed.
+	   ALG_HIST: the same sequence; read() returns the keys (low 8 bits)
+	   in ascending order from the histogram.
+	   A core without the stream heap (NET_LANES > 0, STATUS SH bit 0) sorts
+	   ALG_STREAM with its engine: sorted_on_load() tells whether sort() is
+	   needed. */
+	bool sorted_on_load(); // no sort phase: ALG_STREAM on a core with the heap, or ALG_HIST
 
 	/* Control Flow */
 	void init_write(); //initialize write conditions => 110 to ctrl_reg: rw=1, init=1, s=0 (0x06)
 	void init_read(); //initialize read conditions (Start Readout/Read) => 010 to control_reg: rw=0, init=1, s=0 (0x02)
 	void idle(); // all=0 -> 0x00 (Return to Idle/Stop Sorting)
 	void sort(); //write '1' to control register => start sorting s=1 -> 0x01
+	/* interrupt driven: sort_async() starts sorting and returns, the Done
+	   interrupt (INTC_SORT_IRQ) calls callback(arg) in interrupt context */
+	void sort_async(void (*callback)(void *arg) = 0, void *arg = 0);
+	void wait(); // returns once the sort started by sort_async() is done
+	bool busy(); // sort_async() still waiting for Done (no bus access)
 
 	/* Data Transfer */
 	void write(uint16_t data); //write a 16-bit data to MEMW_ri_REG
 	uint16_t read(); //reads and returns a 8-bit data from a specified address in memory
+	/* block transfers: two values (four with w <= 8) per bus word, the
+	   odd tail and ALG_STREAM use write()/read() */
+	void write_block(const uint16_t *data, int n); // after init_write()
+	void read_block(uint16_t *data, int n); // after init_read()
+	void write_key(uint32_t key); // write a key of up to key_width() bits to MEMW_ri_REG
+	uint32_t read_key(); // key of MEM[ri], ri unchanged (follow with read_index())
+	uint16_t read_index(); // index of MEM[ri] & ri++
+	/* random access in any mode, two bus accesses each; ri is left at i,
+	   so a block transfer after it restarts with init_write()/init_read().
+	   write_at() counts as a load for verify() and the histogram (so an
+	   overwrite fails verify()), read_at() is not part of the readback. */
+	uint32_t read_at(int i); // key of MEM[i]
+	void write_at(int i, uint32_t v); // MEM[i] <= v (not pushed into the ALG_STREAM heap)
+	/* histogram of the low 8 key bits of the elements written since
+	   init_write(), counted during the load in every mode; hist[256].
+	   Leaves the core in read mode at MEM[0]. */
+	void read_histogram(uint16_t *hist);
+	/* on-core data generator: fills MEM[0..n-1] at one element per clock
+	   instead of n bus writes (w = 8 keeps the low byte), returns when done;
+	   replaces init_write() + write_block(). seed: LFSR state before the first
+	   element. */
+	void generate(int n, int pattern, int w = 16, uint16_t seed = 0xACE1);
+	/* zero-copy memory window: buffer()[k] is the key of MEM[k], so the data
+	   set is built and the result read in place, one bus access per element
+	   and no array in processor RAM. set_n(), init_write(), fill, sort(),
+	   init_read(), read in place; reads in ascending order count for
+	   verify(). Same bank as write()/read() (the host bank with double
+	   buffering); ALG_STREAM/ALG_HIST results are only returned by read().
+	   Null (!buffer()) if the core has no window. */
+	io_ptr_t buffer();
+
+	/* Records (core built with INDEX = true): every element carries the
+	   position it was loaded at, equal keys keep their load order.
+	   perm[i] = position in keys[] of the i-th smallest key; sorted[i] (if
+	   given) = that key. With ALG_SELECT selected the call sorts with
+	   ALG_RADIX (stable, so ties keep their load order) and restores
+	   ALG_SELECT. Returns false if the core has no index field, double
+	   buffering is on or ALG_HIST is selected. */
+	bool sort_index(const uint32_t *keys, int n, uint16_t *perm, uint32_t *sorted = 0);
+
+	/* Top-K: out[0..k-1] = the k smallest values of data[] in ascending
+	   order. The selection sort stops after k outer iterations (~N k
+	   clocks instead of ~N^2/2) and only k values are read back; merge,
+	   radix, stream and hist sort all n. With ALG_SELECT selected the call
+	   runs the selection sort and restores ALG_SELECT. Returns false with
+	   double buffering on. */
+	bool partial_sort(const uint16_t *data, int n, int k, uint16_t *out);
+
+	/* Order statistics of the data set in the core (loaded with
+	   init_write() + write_block(), generate() or buffer()): out[i] = the
+	   value of rank ranks[i] (0: smallest, n-1: largest), e.g. n/2 for the
+	   median. One rank runs ALG_SELECT (radix selection, ~2N clocks whatever
+	   the order), several ranks one ALG_RADIX sort; then one read_at() per
+	   rank. Banked and network cores sort instead (partial with one rank).
+	   The data set is reordered. Returns false with double buffering on or
+	   sorted_on_load(), or when a rank is not below N; the
+	   selected algorithm is restored, K is left at 0. */
+	bool select(const uint16_t *ranks, int n, uint32_t *out);
+
+	/* Batch pipeline: with double buffering the next batch is loaded into the
+	   host bank and the previous result read from it while the core sorts.
+	   Call order: submit(b0), then submit(b[k]) / collect(out[k-1]) pairs,
+	   then collect() until it returns 0. */
+	bool set_double_buffer(bool on); // returns false if the core has no host bank
+	bool submit(const uint16_t *data, int n); // false: collect() the ready result first
+	int collect(uint16_t *data); // returns the batch size, 0 when nothing is pending
+
+	/* External sort for n > RUN_SIZE: the data is cut into RUN_SIZE runs
+	   that are sorted on the core through submit()/collect() (double
+	   buffered when the core has a host bank), then merged on the CPU with
+	   a loser tree, MAX_RUNS runs per pass. The runs are sorted with
+	   ALG_RADIX and K = 0; the selected algorithm is restored afterwards
+	   (K is left at 0). tmp must hold n elements; the result is left in
+	   data. */
+	void sort_external(uint16_t *data, uint32_t n, uint16_t *tmp);
 
 
 	/* Status */
 	bool done(); //reads and returns the status register as 8-bits returns true if done bit is 1
+	/* after reading back all n elements: true if they came out in ascending
+	   order and are the elements loaded since init_write() (order-independent
+	   count/sum/XOR checksum in the core), no reference sort needed. One data
+	   set at a time: with double buffering the checksums belong to different
+	   batches. */
+	bool verify();
+	int key_width(); // KEY_WIDTH of the core (16 unless built for wider keys)
 	
 private: 
 	uint32_t base_addr;
+	uint32_t win_addr; // memory window base address (0: none)
 	uint32_t wr_data;
+	uint32_t mode; // alg field ORed into every CTRL_REG write
+	int width; // data width set by set_width()
+	bool dbuf; // double buffering enabled
+	int n_sorting; // size of the batch in the core (0: none)
+	int n_ready; // size of the sorted batch waiting for collect() (0: none)
+	int n_set; // N last written by set_n() (N_REG is write-only; 0 reads as RUN_SIZE)
+	int heap; // STATUS SH bit, read on first use (-1: not yet)
+
+	volatile bool pending; // sort_async() waiting for the interrupt
+	void (*callback)(void *arg);
+	void *callback_arg;
+	bool irq_attached;
+
+	bool streaming(); // ALG_STREAM selected and the core has the heap: per-element writes
+	static void done_isr(void *arg); // INTC_SORT_IRQ handler
+	void swap_result(); // wait for the Done interrupt, stop and move the result to the host bank
+	static uint32_t run_len(uint32_t n, uint32_t r, uint32_t len); // size of run r
+	static void merge_runs(const uint16_t *src, uint16_t *dst, uint32_t n,
+			uint32_t first, int k, uint32_t len); // loser tree merge pass
 
 };
 #endif
@@ -44,7 +44,23 @@ uint64_t TimerCore::read_tick() {
    uint64_t upper, lower;
 
    lower = (uint64_t) io_read(base_addr, COUNTER_LOWER_REG);
-   upper = (uint64_t) io_read(base_addr, COUNTER_UPPER_REG);
+   upper = (uint64_t) io_read(base_addr, SNAP_UPPER_REG);
+   return ((upper << 32) | lower);
+}
+
+uint64_t TimerCore::read_capture(int n) {
+   uint64_t upper, lower;
+
+   lower = (uint64_t) io_read(base_addr, CAP_LOWER_REG + 2 * n);
+   upper = (uint64_t) io_read(base_addr, CAP_UPPER_REG + 2 * n);
+   return ((upper << 32) | lower);
+}
+
+uint64_t TimerCore::read_free_tick() {
+   uint64_t upper, lower;
+
+   lower = (uint64_t) io_read(base_addr, FREE_LOWER_REG);
+   upper = (uint64_t) io_read(base_addr, FREE_UPPER_REG);
    return ((upper << 32) | lower);
 }
 
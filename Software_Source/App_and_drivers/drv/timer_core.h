@@ -27,7 +27,15 @@ public:
    enum {
       COUNTER_LOWER_REG = 0, /**< lower 32 bits of counter */
       COUNTER_UPPER_REG = 1, /**< upper 16 bits of counter */
-      CTRL_REG = 2           /**< control register */
+      CTRL_REG = 2,          /**< control register */
+      SNAP_UPPER_REG = 3,    /**< upper 16 bits latched by the last read of COUNTER_LOWER_REG */
+      CAP_LOWER_REG = 4,     /**< lower 32 bits of capture register 0 (n: 4 + 2n) */
+      CAP_UPPER_REG = 5,     /**< upper 16 bits of capture register 0 (n: 5 + 2n) */
+      FREE_LOWER_REG = 16,   /**< lower 32 bits of the free-running counter */
+      FREE_UPPER_REG = 17    /**< upper 16 bits latched by the last read of FREE_LOWER_REG */
+   };
+   enum {
+      CAP_NUM = 6            /**< capture registers (cap inputs) */
    };
    /**
    * field masks
@@ -69,9 +77,29 @@ public:
    /**
     * read current timing counter value (# clocks elapsed from last clear)
     *
+    * @note the upper bits come from the snapshot taken with the lower
+    *       32 bits, so a carry between the two reads cannot tear the value
+    *
     */
    uint64_t read_tick();
 
+   /**
+    * read capture register n (counter value at the last cap(n) pulse)
+    *
+    * @param n capture register, 0 .. CAP_NUM-1
+    * @note 0 if there was no pulse since the last clear
+    *
+    */
+   uint64_t read_capture(int n);
+
+   /**
+    * read the free-running counter (# clocks elapsed from reset)
+    *
+    * @note not affected by go/pause or clear; tear-free like read_tick()
+    *
+    */
+   uint64_t read_free_tick();
+
    /**
     * read current time (microseconds elapsed from last clear)
     *
@@ -8,9 +8,17 @@
  ********************************************************************/
 
 #include "uart_core.h"
+#include "mcs_intc.h"
 
 UartCore::UartCore(uint32_t core_base_addr) {
    base_addr = core_base_addr;
+   tx_buf = 0;
+   tx_size = 0;
+   tx_head = tx_tail = 0;
+   ovf_policy = OVF_BLOCK;
+   n_dropped = 0;
+   tx_irq = -1;
+   tx_ie = 0;
    set_baud_rate(9600);      //default baud rate
 }
 
@@ -43,6 +51,15 @@ int UartCore::tx_fifo_full() {
    return (full);
 }
 
+int UartCore::tx_fifo_empty() {
+   uint32_t rd_word;
+   int empty;
+
+   rd_word = io_read(base_addr, RD_DATA_REG);
+   empty = (int) (rd_word & TX_EMPT_FIELD) >> 10;
+   return (empty);
+}
+
 void UartCore::tx_byte(uint8_t byte) {
    while (tx_fifo_full()) {
    };  // busy waiting
@@ -66,7 +83,7 @@ void UartCore::disp(const char *str) {
 }
 
 void UartCore::disp(char ch) {
-    tx_byte(ch);
+   put(ch);
 }
 
 void UartCore::disp(int n, int base, int len) {
@@ -126,6 +143,18 @@ void UartCore::disp(int n, int base) {
    disp(n, base, 0);
 }
 
+void UartCore::disp_u64(uint64_t n) {
+   char buf[21];         // 64 bit #
+   char *str = &buf[20];
+
+   *str = '\0';
+   do {
+      *--str = (char) (n % 10) + '0';
+      n = n / 10;
+   } while (n);
+   disp_str(str);
+}
+
 void UartCore::disp(double f, int digit) {
    double fa, frac; // absolute value of f
    int n, i, i_part;
@@ -155,9 +184,130 @@ void UartCore::disp(double f) {
 
 void UartCore::disp_str(const char *str) {
    while ((uint8_t) *str) {
-      tx_byte(*str);
+      put(*str);
       str++;
    }
 }
 
+/* buffered output: disp() is the only producer (tx_head); poll(), flush()
+   and the interrupt consume (tx_tail) with the interrupt masked or from it */
+void UartCore::set_buffer(uint8_t *buf, int size, int policy) {
+   int ie;
+
+   flush();
+   ie = lock();
+   tx_buf = (size > 1) ? buf : 0;
+   tx_size = size;
+   tx_head = tx_tail = 0;
+   ovf_policy = policy;
+   n_dropped = 0;
+   unlock(ie);
+}
+
+void UartCore::enable_tx_irq(int irq) {
+   tx_irq = irq;
+   tx_ie = 0;
+   io_write(base_addr, CTRL_REG, 0);
+   intc_attach(irq, tx_isr, this);
+   intc_enable(irq);
+}
+
+int UartCore::poll() {
+   if (tx_buf && tx_irq < 0)
+      drain();
+   return (pending());
+}
+
+void UartCore::flush() {
+   int ie;
+
+   if (!tx_buf)
+      return;
+   ie = lock();
+   while (tx_tail != tx_head)
+      drain();
+   unlock(ie);
+}
+
+int UartCore::pending() {
+   int n;
+
+   n = tx_head - tx_tail;
+   return ((n < 0) ? n + tx_size : n);
+}
+
+uint32_t UartCore::dropped() {
+   return (n_dropped);
+}
+
+void UartCore::put(uint8_t byte) {
+   int next, ie;
+
+   if (!tx_buf) {
+      tx_byte(byte);
+      return;
+   }
+   next = (tx_head + 1 == tx_size) ? 0 : tx_head + 1;
+   if (next == tx_tail) { // full
+      if (ovf_policy == OVF_DROP_NEW) {
+         n_dropped++;
+         return;
+      }
+      ie = lock();
+      if (next == tx_tail) {
+         if (ovf_policy == OVF_DROP_OLD) {
+            tx_tail = (tx_tail + 1 == tx_size) ? 0 : tx_tail + 1;
+            n_dropped++;
+         } else {
+            while (next == tx_tail)
+               drain();
+         }
+      }
+      unlock(ie);
+   }
+   tx_buf[tx_head] = byte;
+   tx_head = next;
+   // the interrupt disables itself when the buffer runs empty
+   if (tx_irq >= 0 && !tx_ie) {
+      tx_ie = 1;
+      io_write(base_addr, CTRL_REG, TX_IE_FIELD);
+   }
+}
+
+/* queued bytes to the tx fifo until it is full */
+void UartCore::drain() {
+   while (tx_tail != tx_head && !tx_fifo_full()) {
+      io_write(base_addr, WR_DATA_REG, (uint32_t) tx_buf[tx_tail]);
+      tx_tail = (tx_tail + 1 == tx_size) ? 0 : tx_tail + 1;
+   }
+}
+
+/* the caller may have masked the line already (e.g. around a timed
+   section): unlock() re-enables it only if lock() found it enabled */
+int UartCore::lock() {
+   int ie;
+
+   if (tx_irq < 0)
+      return (0);
+   ie = intc_enabled(tx_irq);
+   intc_disable(tx_irq);
+   return (ie);
+}
+
+void UartCore::unlock(int ie) {
+   if (tx_irq >= 0 && ie)
+      intc_enable(tx_irq);
+}
+
+/* tx fifo empty: refill it; no more bytes, no more interrupts */
+void UartCore::tx_isr(void *arg) {
+   UartCore *u = (UartCore *) arg;
+
+   u->drain();
+   if (u->tx_tail == u->tx_head) {
+      u->tx_ie = 0;
+      io_write(u->base_addr, CTRL_REG, 0);
+   }
+}
+
 
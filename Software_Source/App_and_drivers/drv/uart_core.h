@@ -28,18 +28,30 @@ class UartCore {
       RD_DATA_REG = 0,   /**< rx data/status register */
       DVSR_REG = 1,      /**< baud rate divisor register */
       WR_DATA_REG = 2,   /**< wr data register */
-      RM_RD_DATA_REG = 3 /**< remove read data offset */
+      RM_RD_DATA_REG = 3, /**< remove read data offset */
+      CTRL_REG = 4       /**< tx interrupt enable register */
    };
   /**
    * mask fields
    *
    */
    enum {
+      TX_EMPT_FIELD = 0x00000400, /**< bit 10 of rd_data_reg; tx empty bit */
       TX_FULL_FIELD = 0x00000200, /**< bit 9 of rd_data_reg; full bit  */
       RX_EMPT_FIELD = 0x00000100, /**< bit 10 of rd_data_reg; empty bit */
-      RX_DATA_FIELD = 0x000000ff  /**< bits 7..0 rd_data_reg; read data */
+      RX_DATA_FIELD = 0x000000ff, /**< bits 7..0 rd_data_reg; read data */
+      TX_IE_FIELD = 0x00000001    /**< bit 0 of ctrl_reg; tx empty interrupt enable */
    };
 public:
+   /**
+    * overflow policy of the transmit buffer (set_buffer())
+    *
+    */
+   enum {
+      OVF_DROP_NEW = 0, /**< full buffer: discard the new byte */
+      OVF_DROP_OLD = 1, /**< full buffer: discard the oldest byte */
+      OVF_BLOCK = 2     /**< full buffer: send bytes until one is free */
+   };
    /* methods */
    /**
     * constructor.
@@ -73,6 +85,14 @@ public:
     */
    int tx_fifo_full();
 
+   /**
+    * check whether uart transmitter fifo is empty
+    *
+    * @return 1: if empty; 0: otherwise
+    *
+    */
+   int tx_fifo_empty();
+
    /**
     * transmit a byte
     *
@@ -143,6 +163,17 @@ public:
     */
    void disp(int n);
 
+   /**
+    * display (print) a 64-bit unsigned integer on a serial terminal console
+    *
+    * @param n integer to be displayed
+    * @note base 10 used, no blanks
+    * @note separate name: a disp(uint64_t) overload would make
+    *       disp() of a 32-bit unsigned value ambiguous
+    *
+    */
+   void disp_u64(uint64_t n);
+
    /**
     * display (print) a floating-point number on a serial terminal console
     *
@@ -165,10 +196,70 @@ public:
     */
    void disp(double f);
 
+   /**
+    * buffer the disp() output in RAM
+    *
+    * @param buf ring buffer; 0 returns to unbuffered output
+    * @param size buffer size in bytes (size-1 bytes are queued)
+    * @param policy OVF_DROP_NEW/OVF_DROP_OLD/OVF_BLOCK when the buffer is full
+    *
+    * @note disp() queues the bytes and returns; they are sent by poll(),
+    *       flush() or the tx interrupt (enable_tx_irq())
+    * @note tx_byte() still writes the fifo directly
+    */
+   void set_buffer(uint8_t *buf, int size, int policy);
+
+   /**
+    * drain the buffer by the tx fifo empty interrupt
+    *
+    * @param irq MCS external interrupt line of the uart (INTC_UART_TX_IRQ)
+    *
+    * @note the interrupt is enabled only while bytes are queued
+    */
+   void enable_tx_irq(int irq);
+
+   /**
+    * move queued bytes to the tx fifo until it is full (main loop)
+    *
+    * @return # bytes still queued
+    *
+    * @note does not wait; nothing to do when the tx interrupt drains
+    */
+   int poll();
+
+   /**
+    * send all queued bytes to the tx fifo ("busy waits")
+    *
+    */
+   void flush();
+
+   /**
+    * @return # bytes queued
+    */
+   int pending();
+
+   /**
+    * @return # bytes discarded by the overflow policy
+    */
+   uint32_t dropped();
+
 private:
    uint32_t base_addr;
    int baud_rate;
+   uint8_t *tx_buf;           // ring buffer, 0: unbuffered
+   int tx_size;
+   volatile int tx_head;      // next free byte (disp())
+   volatile int tx_tail;      // next byte to send (poll(), flush(), interrupt)
+   int ovf_policy;
+   volatile uint32_t n_dropped;
+   int tx_irq;                // interrupt line, -1: drained by poll()
+   volatile int tx_ie;        // tx interrupt enabled in the core
    void disp_str(const char *str);
+   void put(uint8_t byte);
+   void drain();
+   int lock();                // mask the tx interrupt, returns its previous enable
+   void unlock(int ie);       // restore the enable returned by lock()
+   static void tx_isr(void *arg);
 };
 
 #endif  // _UART_CORE_H_INCLUDED
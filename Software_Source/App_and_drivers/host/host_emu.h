@@ -0,0 +1,63 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: host_emu.h
+ * Author: Kainoa Asse
+ * Description:
+ * Pluggable device-model interface and emulated system clock for the
+ * _HOST_EMU build. A model implements the register file of one MMIO slot;
+ * host_io_read()/host_io_write() dispatch to it.
+ *
+ * Emulated clock (in SYS_CLK_FREQ cycles):
+ *   host_cycles() = host wall-clock time since start * SYS_CLK_FREQ
+ *                 + cycles charged by host_stall()
+ * (host time spent inside a model during an access is excluded).
+ * Every MMIO access charges the bus cost (host_set_io_cost()) and a model
+ * that is polled while busy may stall the clock forward to its completion,
+ * so hardware time is deterministic while software time is real host time.
+ *
+ * Interrupts: a model drives a level output (irq()) wired to an MCS
+ * external interrupt line with host_attach_irq(); enabled lines are checked
+ * after every MMIO access and by intc_idle() (see drv/mcs_intc.h).
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _HOST_EMU_H_INCLUDED
+#define _HOST_EMU_H_INCLUDED
+
+#ifdef _HOST_EMU
+
+#include <inttypes.h>
+
+class HostDevice {
+public:
+	virtual ~HostDevice() {}
+	virtual uint32_t read(int reg) = 0;          // register read (reg = word offset in slot)
+	virtual void write(int reg, uint32_t data) = 0; // register write
+	virtual uint32_t win_read(int /*addr*/) { return 0; } // memory window read (word addr in video slot)
+	virtual void win_write(int /*addr*/, uint32_t /*data*/) {} // memory window write
+	virtual bool irq_armed() { return false; }   // irq() may be high (cheap, no clocking)
+	virtual bool irq() { return false; }         // interrupt output level
+	virtual bool run_to_irq() { return false; }  // idle bus until irq() rises; false: it never will
+	virtual void capture(int /*n*/, uint64_t /*cycle*/) {} // capture input n pulsed at emulated clock cycle
+};
+
+/* Slot wiring */
+void host_attach(int slot, HostDevice *dev); // attach (or replace, or detach with 0) a slot model
+HostDevice *host_device(int slot);           // model currently attached to a slot
+void host_attach_irq(int irq, HostDevice *dev); // wire a model's irq() to INTC_Interrupt(irq)
+void host_attach_video(int slot, HostDevice *dev); // attach a memory window to a video slot
+
+/* Timer capture wiring (chu_timer cap inputs) */
+void host_capture(int n, uint64_t cycle); // pulse cap(n) of the system timer at emulated clock cycle
+
+/* Emulated clock */
+uint64_t host_cycles();                 // current emulated clock count
+void host_stall(uint64_t cycles);       // advance the emulated clock without host work
+void host_set_io_cost(uint32_t cycles); // cycles charged per MMIO access (default HOST_IO_CYCLES)
+void host_set_wall_clock(bool on);      // false: host work between accesses takes no time (default true)
+
+#define HOST_IO_CYCLES 4 // approx. MicroBlaze MCS I/O bus read/write cost
+
+#endif  // _HOST_EMU
+
+#endif  // _HOST_EMU_H_INCLUDED
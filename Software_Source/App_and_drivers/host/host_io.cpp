@@ -0,0 +1,222 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: host_io.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Address decoding, slot dispatch and emulated clock of the _HOST_EMU build.
+ * The default board (slots from chu_io_map.h) is wired on first access so
+ * global driver objects constructed before main() already reach their models.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifdef _HOST_EMU
+
+#include <chrono>
+#include "host_io.h"
+#include "host_emu.h"
+#include "host_models.h"
+#include "sort_core_model.h"
+#include "../drv/chu_io_map.h"
+#include "../drv/mcs_intc.h"
+
+static HostDevice *slot_table[64];
+static HostDevice *video_table[8];
+static HostDevice *capture_dev; // timer with the cap inputs
+static HostBusMonitor *bus_mon; // counts every access of the MMIO slots and the video space
+static uint64_t stall_cycles = 0;
+static uint32_t io_cost = HOST_IO_CYCLES;
+static uint64_t model_ns = 0;  // host time spent inside device models
+static uint64_t frozen_ns = 0; // emulated time seen by a model during an access
+static bool in_model = false;
+static bool wall_clock = true; // host time between accesses is application time
+static uint64_t held_ns = 0;   // application time while wall_clock is off
+/* MCS external interrupt lines */
+static HostDevice *irq_table[16];
+static intc_handler_t irq_handler[16];
+static void *irq_arg[16];
+static uint16_t irq_enabled = 0;
+static bool in_isr = false;
+
+// default sampler configuration: timer, uart, switches, sorting core and bus monitor
+static void board_init() {
+	static bool wired = false;
+	if (wired) return;
+	wired = true;
+
+	static HostTimer timer;
+	static HostUart uart;
+	static HostGpi sw;
+	static HostBusMonitor mon;
+	static SortCoreModel sort(true, HOST_NET_LANES, HOST_KEY_WIDTH, HOST_INDEX, HOST_SEL_LANES,
+			HOST_RADIX_BITS, HOST_DB_BANK);
+	slot_table[S0_SYS_TIMER] = &timer;
+	capture_dev = &timer;
+	slot_table[S14_BUS_MON] = &mon;
+	bus_mon = &mon;
+	slot_table[S1_UART1] = &uart;
+	slot_table[S3_SW] = &sw;
+	slot_table[S4_USER] = &sort;
+	irq_table[INTC_SORT_IRQ] = &sort;
+	irq_table[INTC_UART_TX_IRQ] = &uart;
+	video_table[V4_USER4] = &sort;
+}
+
+void host_attach(int slot, HostDevice *dev) {
+	board_init();
+	slot_table[slot & 0x3f] = dev;
+}
+
+HostDevice *host_device(int slot) {
+	board_init();
+	return slot_table[slot & 0x3f];
+}
+
+void host_attach_video(int slot, HostDevice *dev) {
+	board_init();
+	video_table[slot & 0x07] = dev;
+}
+
+void host_capture(int n, uint64_t cycle) {
+	board_init();
+	capture_dev->capture(n, cycle);
+}
+
+void host_attach_irq(int irq, HostDevice *dev) {
+	board_init();
+	irq_table[irq & 0x0f] = dev;
+}
+
+static uint64_t wall_ns() {
+	static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+}
+
+// time spent simulating a model is not application time; the clock is
+// frozen during an access and that host time is excluded afterwards
+uint64_t host_cycles() {
+	uint64_t ns = !wall_clock ? held_ns : in_model ? frozen_ns : wall_ns() - model_ns;
+	return ns * SYS_CLK_FREQ / 1000 + stall_cycles;
+}
+
+// off: only the accesses, stalls and models advance the clock (repeatable
+// counts); the clock carries on from where it stood when switched back on
+void host_set_wall_clock(bool on) {
+	if (on == wall_clock) return;
+	if (on) model_ns = wall_ns() - held_ns;
+	else held_ns = wall_ns() - model_ns;
+	wall_clock = on;
+}
+
+void host_stall(uint64_t cycles) {
+	stall_cycles += cycles;
+}
+
+void host_set_io_cost(uint32_t cycles) {
+	io_cost = cycles;
+}
+
+// decode like chu_mcs_bridge (bit 23 = video) and chu_mmio_controller
+static HostDevice *decode(uint32_t addr, int *reg, bool *video, bool wr) {
+	uint32_t word_addr = (addr - BRIDGE_BASE) >> 2;
+
+	board_init();
+	host_stall(io_cost);
+	*video = word_addr & 0x00200000;
+	if (*video) {
+		*reg = (int) (word_addr & 0x3fff);
+		bus_mon->count_video(wr);
+		return video_table[(word_addr >> 14) & 0x07];
+	}
+	*reg = (int) (word_addr & 0x1f);
+	bus_mon->count((word_addr >> 5) & 0x3f, wr);
+	return slot_table[(word_addr >> 5) & 0x3f];
+}
+
+// run f() inside a model with the clock frozen
+template <class F> static void model_call(F f) {
+	uint64_t t0 = wall_ns();
+	frozen_ns = t0 - model_ns;
+	in_model = true;
+	f();
+	in_model = false;
+	model_ns += wall_ns() - t0;
+}
+
+// MCS INTC: call the handler of every enabled line whose input is high
+// (level sensitive; the handler clears the source). Handlers are not nested.
+static bool deliver_irq() {
+	bool taken = false;
+	if (in_isr || !irq_enabled) return false;
+	in_isr = true;
+	for (int i = 0; i < 16; i++) {
+		bool level = false;
+		HostDevice *dev = irq_table[i];
+		if (!(irq_enabled & (1 << i)) || !dev || !irq_handler[i] || !dev->irq_armed()) continue;
+		model_call([&] { level = dev->irq(); });
+		if (level) {
+			irq_handler[i](irq_arg[i]);
+			taken = true;
+		}
+	}
+	in_isr = false;
+	return taken;
+}
+
+uint32_t host_io_read(uint32_t addr) {
+	int reg;
+	bool video;
+	uint32_t data = 0;
+	HostDevice *dev = decode(addr, &reg, &video, false);
+	if (dev)
+		model_call([&] { data = video ? dev->win_read(reg) : dev->read(reg); });
+	deliver_irq();
+	return data;
+}
+
+void host_io_write(uint32_t addr, uint32_t data) {
+	int reg;
+	bool video;
+	HostDevice *dev = decode(addr, &reg, &video, true);
+	if (dev)
+		model_call([&] {
+			if (video) dev->win_write(reg, data);
+			else dev->write(reg, data);
+		});
+	deliver_irq();
+}
+
+/* mcs_intc.h */
+void intc_attach(int irq, intc_handler_t handler, void *arg) {
+	board_init();
+	irq_handler[irq & 0x0f] = handler;
+	irq_arg[irq & 0x0f] = arg;
+}
+
+void intc_enable(int irq) {
+	irq_enabled |= 1 << (irq & 0x0f);
+	deliver_irq(); // a level already high is taken at once
+}
+
+void intc_disable(int irq) {
+	irq_enabled &= ~(1 << (irq & 0x0f));
+}
+
+int intc_enabled(int irq) {
+	return (irq_enabled >> (irq & 0x0f)) & 1;
+}
+
+// the CPU has nothing to do: skip the emulated clock to the next interrupt
+void intc_idle() {
+	if (deliver_irq()) return;
+	for (int i = 0; i < 16; i++) {
+		bool coming = false;
+		HostDevice *dev = irq_table[i];
+		if (!(irq_enabled & (1 << i)) || !dev || !irq_handler[i]) continue;
+		model_call([&] { coming = dev->run_to_irq(); });
+		if (coming) break;
+	}
+	deliver_irq();
+}
+
+#endif  // _HOST_EMU
@@ -0,0 +1,67 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: host_io.h
+ * Author: Kainoa Asse
+ * Description:
+ * Host-side (Linux) io_read()/io_write() backend. Pulled in by chu_io_rw.h
+ * when _HOST_EMU is defined. Every access is decoded exactly like
+ * chu_mcs_bridge/chu_mmio_controller (slot = addr bits 10..5, register =
+ * addr bits 4..0) and forwarded to the C++ device model attached to that
+ * slot (see host_emu.h). Unattached slots read 0 and ignore writes.
+ * Video slots (addr bit 23, 2^14 words each) reach the memory window of
+ * the model attached with host_attach_video(); io_ptr_t stands in for the
+ * volatile pointer of the board build, so buf[k] is a bus access here too.
+ *
+ * Host build (from App_and_drivers):
+ *   g++ -O2 -D_HOST_EMU -o sort_host project_main.cpp drv/[a-z]*.cpp host/[a-z]*.cpp
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _HOST_IO_H_INCLUDED
+#define _HOST_IO_H_INCLUDED
+
+#include <inttypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t host_io_read(uint32_t addr); // read the register at byte address addr
+void host_io_write(uint32_t addr, uint32_t data); // write the register at byte address addr
+
+#define io_read(base_addr, offset) \
+   host_io_read((uint32_t)((base_addr) + 4*(offset)))
+
+#define io_write(base_addr, offset, data) \
+   host_io_write((uint32_t)((base_addr) + 4*(offset)), (uint32_t)(data))
+
+#ifdef __cplusplus
+/* io_ptr_t: element k is the word at byte address base + 4*k */
+class HostIoPtr {
+public:
+	class Ref {
+	public:
+		Ref(uint32_t a) : addr(a) {}
+		operator uint32_t() const { return host_io_read(addr); }
+		Ref &operator=(uint32_t data) { host_io_write(addr, data); return *this; }
+		Ref &operator=(const Ref &r) { host_io_write(addr, (uint32_t) r); return *this; }
+	private:
+		uint32_t addr;
+	};
+	HostIoPtr(uint32_t base = 0) : addr(base) {}
+	Ref operator[](uint32_t k) const { return Ref(addr + 4 * k); }
+	Ref operator*() const { return Ref(addr); }
+	HostIoPtr operator+(uint32_t k) const { return HostIoPtr(addr + 4 * k); }
+	bool operator!() const { return addr == 0; }
+private:
+	uint32_t addr;
+};
+typedef HostIoPtr io_ptr_t;
+#define io_ptr(base_addr) HostIoPtr((uint32_t)(base_addr))
+#endif
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif  // _HOST_IO_H_INCLUDED
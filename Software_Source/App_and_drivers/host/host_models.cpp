@@ -0,0 +1,185 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: host_models.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Implements the timer, bus monitor, uart and gpi models of the _HOST_EMU
+ * build. Register offsets follow chu_timer.vhd, chu_mmio_controller.vhd,
+ * chu_uart.vhd and chu_gpi.vhd.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifdef _HOST_EMU
+
+#include <stdio.h>
+#include "host_models.h"
+
+/**********************************************************************
+ * HostTimer
+ **********************************************************************/
+HostTimer::HostTimer() {
+	count = 0;
+	last = 0;
+	go = false;
+	snap = 0;
+	free_snap = 0;
+	for (int i = 0; i < 6; i++)
+		cap[i] = 0;
+}
+
+uint64_t HostTimer::now_count() {
+	uint64_t now = host_cycles();
+	if (go)
+		count += now - last;
+	last = now;
+	return count & 0x0000FFFFFFFFFFFFULL; // 48-bit counter
+}
+
+uint32_t HostTimer::read(int reg) {
+	uint64_t c = now_count();
+	int r = reg & 0x1f;
+	// 0/1 counter, 2 ctrl, 3 snapshot, 4..15 capture n at 4 + 2n,
+	// 16/17 free-running counter (emulated clock since reset)
+	if (r >= 4 && r < 16)
+		c = cap[(r - 4) / 2];
+	if (r == 16 || r == 17)
+		c = host_cycles() & 0x0000FFFFFFFFFFFFULL;
+	if (r == 0)
+		snap = (uint32_t) (c >> 32);
+	if (r == 16)
+		free_snap = (uint32_t) (c >> 32);
+	if (r == 3)
+		return snap;
+	if (r == 17)
+		return free_snap;
+	// addr(0) selects the upper 16 bits, as in chu_timer
+	return (reg & 0x01) ? (uint32_t) (c >> 32) : (uint32_t) c;
+}
+
+void HostTimer::write(int reg, uint32_t data) {
+	if ((reg & 0x03) != 0x02)
+		return;
+	now_count();
+	if (data & 0x02) {
+		count = 0;   // clear pulse
+		for (int i = 0; i < 6; i++)
+			cap[i] = 0;
+	}
+	go = data & 0x01;
+}
+
+// counter value at cycle (a model may run ahead of the host clock)
+void HostTimer::capture(int n, uint64_t cycle) {
+	now_count();
+	uint64_t c = count;
+	if (go && cycle > last)
+		c += cycle - last;
+	cap[n] = c & 0x0000FFFFFFFFFFFFULL;
+}
+
+/**********************************************************************
+ * HostBusMonitor
+ **********************************************************************/
+HostBusMonitor::HostBusMonitor() {
+	for (int i = 0; i < SLOTS; i++)
+		rd_count[i] = wr_count[i] = 0;
+	video_rd_count = video_wr_count = 0;
+	cycles = 0;
+	last = 0;
+	snap = 0;
+	freeze = sel_wr = false;
+}
+
+uint64_t HostBusMonitor::now_cycles() {
+	uint64_t now = host_cycles();
+	if (!freeze)
+		cycles += now - last;
+	last = now;
+	return cycles & 0x0000FFFFFFFFFFFFULL;
+}
+
+void HostBusMonitor::count(int slot, bool wr) {
+	if (freeze || slot >= SLOTS)
+		return;
+	if (wr) wr_count[slot]++;
+	else rd_count[slot]++;
+}
+
+void HostBusMonitor::count_video(bool wr) {
+	if (freeze)
+		return;
+	if (wr) video_wr_count++;
+	else video_rd_count++;
+}
+
+uint32_t HostBusMonitor::read(int reg) {
+	reg &= 0x1f;
+	if (reg & 0x10)
+		return sel_wr ? wr_count[reg & 0x0f] : rd_count[reg & 0x0f];
+	if (reg == 0)
+		return SLOTS;
+	if (reg == 2) {
+		uint64_t c = now_cycles();
+		snap = (uint32_t) (c >> 32);
+		return (uint32_t) c;
+	}
+	if (reg == 3)
+		return snap;
+	if (reg == 4)
+		return sel_wr ? video_wr_count : video_rd_count;
+	return 0;
+}
+
+void HostBusMonitor::write(int reg, uint32_t data) {
+	reg &= 0x1f;
+	if (reg == 0) {
+		now_cycles();
+		freeze = data & 0x02;
+		if (data & 0x01) {
+			for (int i = 0; i < SLOTS; i++)
+				rd_count[i] = wr_count[i] = 0;
+			video_rd_count = video_wr_count = 0;
+			cycles = 0;
+		}
+	} else if (reg == 1) {
+		sel_wr = data & 0x01;
+	}
+}
+
+/**********************************************************************
+ * HostUart
+ **********************************************************************/
+HostUart::HostUart() {
+	ie = false;
+}
+
+uint32_t HostUart::read(int /*reg*/) {
+	return 0x00000500; // tx empty, rx empty, tx not full
+}
+
+void HostUart::write(int reg, uint32_t data) {
+	if ((reg & 0x07) == 0x04)
+		ie = data & 0x01;
+	else if ((reg & 0x03) == 0x02)
+		fputc((int) (data & 0xff), stdout);
+}
+
+/**********************************************************************
+ * HostGpi
+ **********************************************************************/
+HostGpi::HostGpi() {
+	din = 0;
+}
+
+uint32_t HostGpi::read(int /*reg*/) {
+	return din;
+}
+
+void HostGpi::write(int /*reg*/, uint32_t /*data*/) {
+}
+
+void HostGpi::set(uint32_t din) {
+	this->din = din;
+}
+
+#endif  // _HOST_EMU
@@ -0,0 +1,89 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: host_models.h
+ * Author: Kainoa Asse
+ * Description:
+ * Register-level C++ models of the standard FPro cores used by the
+ * application in the _HOST_EMU build: chu_timer (counts emulated clock
+ * cycles), chu_uart (tx bytes go to stdout) and chu_gpi (switches).
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _HOST_MODELS_H_INCLUDED
+#define _HOST_MODELS_H_INCLUDED
+
+#ifdef _HOST_EMU
+
+#include "host_emu.h"
+
+/* chu_timer: 48-bit counter, go/pause, 1-clock clear, six capture
+   registers loaded by capture() (cap inputs) and the free-running counter */
+class HostTimer : public HostDevice {
+public:
+	HostTimer();
+	uint32_t read(int reg);
+	void write(int reg, uint32_t data);
+	void capture(int n, uint64_t cycle);
+
+private:
+	uint64_t cap[6];
+	uint32_t snap;    // 16 MSB latched by a read of register 0
+	uint32_t free_snap; // 16 MSB of the free-running counter latched by a read of register 16
+	uint64_t count;   // counter value at the last update
+	uint64_t last;    // emulated clock at the last update
+	bool go;
+	uint64_t now_count();
+};
+
+/* chu_mmio_controller bus monitor (slot S14_BUS_MON): count() is called
+   by the bus for every MMIO access before it is dispatched, count_video()
+   for every access of the video space */
+class HostBusMonitor : public HostDevice {
+public:
+	HostBusMonitor();
+	uint32_t read(int reg);
+	void write(int reg, uint32_t data);
+	void count(int slot, bool wr);
+	void count_video(bool wr);
+
+private:
+	enum { SLOTS = 16 };
+	uint32_t rd_count[SLOTS], wr_count[SLOTS];
+	uint32_t video_rd_count, video_wr_count;
+	uint64_t cycles;  // cycle counter at the last update
+	uint64_t last;    // emulated clock at the last update
+	uint32_t snap;
+	bool freeze, sel_wr;
+	uint64_t now_cycles();
+};
+
+/* chu_uart: transmitter never full (always empty, so the tx interrupt is
+   its enable bit), receiver always empty */
+class HostUart : public HostDevice {
+public:
+	HostUart();
+	uint32_t read(int reg);
+	void write(int reg, uint32_t data);
+	bool irq_armed() { return ie; }
+	bool irq() { return ie; }
+	bool run_to_irq() { return ie; }
+
+private:
+	bool ie;
+};
+
+/* chu_gpi: input word set by the host application */
+class HostGpi : public HostDevice {
+public:
+	HostGpi();
+	uint32_t read(int reg);
+	void write(int reg, uint32_t data);
+	void set(uint32_t din); // drive the input pins
+
+private:
+	uint32_t din;
+};
+
+#endif  // _HOST_EMU
+
+#endif  // _HOST_MODELS_H_INCLUDED
@@ -0,0 +1,906 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: sort_core_model.cpp
+ * Author: Kainoa Asse
+ * Description:
+ * Implements SortCoreModel. clock() evaluates the combinational logic of
+ * controller.vhd, Sorting_datapath.vhd and chu_sorting_core.vhd from the
+ * current register values, then updates every register as on one rising
+ * edge. Signal names follow the VHDL. With NET_LANES > 0 the S0..S4 states
+ * stand for network_controller S0, S1/S2 (busy) and S3 (Done).
+ * -----------------------------------------------------------------------------
+ */
+
+#ifdef _HOST_EMU
+
+#include <algorithm>
+#include "sort_core_model.h"
+#include "../drv/sorting_core.h"
+
+StreamHeapModel::StreamHeapModel(int data_width) {
+	EMPTY = (uint64_t) 1 << data_width;
+	std::fill(&ram[0][0], &ram[0][0] + LEVELS * (1 << (LEVELS - 2)), 0);
+	for (int l = 0; l < LEVELS; l++) {
+		douta[l] = doutb[l] = 0;
+		tv[l] = tph[l] = tpop[l] = false;
+		tval[l] = tpos[l] = 0;
+	}
+	count = 0;
+	top_r = EMPTY;
+}
+
+uint64_t StreamHeapModel::top() {
+	return top_r & (EMPTY - 1);
+}
+
+bool StreamHeapModel::busy() {
+	for (int l = 0; l < LEVELS; l++)
+		if (tv[l]) return true;
+	return false;
+}
+
+// index of the most significant '1' of heap position p
+static int heap_level(uint32_t p) {
+	int l = 0;
+	while (p >> (l + 1))
+		l++;
+	return l;
+}
+
+void StreamHeapModel::clock(bool clr, bool push, bool pop, uint64_t din) {
+	uint32_t addra[LEVELS], addrb[LEVELS];
+	uint64_t dina[LEVELS];
+	bool wea[LEVELS];
+
+	/* level RAM ports */
+	for (int l = 1; l < LEVELS; l++) {
+		uint32_t mask = (l == LEVELS - 1) ? 1 : (1u << l) - 1;
+		bool child_rd = tv[l - 1] && tpop[l - 1] && !tph[l - 1];
+		uint32_t node_pos = tpop[l] ? tpos[l] : tpos[l] >> std::max(0, heap_level(tpos[l]) - l);
+		addra[l] = (child_rd ? 2 * tpos[l - 1] : node_pos) & mask;
+		addrb[l] = (2 * tpos[l - 1] + 1) & mask;
+		wea[l] = false;
+		dina[l] = 0;
+		if (tv[l] && tph[l]) {
+			if (!tpop[l]) {
+				if (heap_level(tpos[l]) == l || tval[l] < douta[l]) {
+					wea[l] = true;
+					dina[l] = tval[l];
+				}
+			} else {
+				uint32_t cpos = 2 * tpos[l];
+				uint64_t c0 = (l < LEVELS - 1 && cpos <= count) ? douta[l + 1] : EMPTY;
+				uint64_t c1 = (l < LEVELS - 1 && cpos + 1 <= count) ? doutb[l + 1] : EMPTY;
+				wea[l] = true;
+				dina[l] = std::min(c0, c1);
+			}
+		}
+	}
+
+	/* rising edge: token pipeline (uses the RAM outputs before the edge) */
+	for (int l = LEVELS - 1; l >= 0; l--) {
+		if (!tv[l])
+			continue;
+		if (!tph[l]) {
+			tph[l] = true;
+			continue;
+		}
+		tv[l] = false;
+		bool go_on = false;
+		uint64_t m = 0;
+		uint32_t next_pos = tpos[l];
+		if (!tpop[l]) {
+			// push: larger value continues towards the target
+			uint64_t node = (l == 0) ? top_r : douta[l];
+			if (heap_level(tpos[l]) == l) {
+				if (l == 0) top_r = tval[l];
+			} else {
+				go_on = true;
+				if (tval[l] < node) {
+					if (l == 0) top_r = tval[l];
+					m = node;
+				} else {
+					m = tval[l];
+				}
+			}
+		} else {
+			// pop: hole moves to the smaller child
+			uint32_t cpos = 2 * tpos[l];
+			uint64_t c0 = (l < LEVELS - 1 && cpos <= count) ? douta[l + 1] : EMPTY;
+			uint64_t c1 = (l < LEVELS - 1 && cpos + 1 <= count) ? doutb[l + 1] : EMPTY;
+			if (c1 < c0) {
+				m = c1;
+				cpos++;
+			} else {
+				m = c0;
+			}
+			if (l == 0) top_r = m;
+			if (!(m & EMPTY)) {
+				go_on = true;
+				next_pos = cpos;
+			}
+		}
+		if (go_on && l < LEVELS - 1) {
+			tv[l + 1] = true;
+			tph[l + 1] = false;
+			tpop[l + 1] = tpop[l];
+			tval[l + 1] = m;
+			tpos[l + 1] = next_pos;
+		}
+	}
+
+	/* rising edge: level RAMs (NO_CHANGE) */
+	for (int l = 1; l < LEVELS; l++) {
+		if (wea[l]) ram[l][addra[l]] = dina[l];
+		else douta[l] = ram[l][addra[l]];
+		doutb[l] = ram[l][addrb[l]];
+	}
+
+	/* new host token enters level 0 */
+	if (push) {
+		tv[0] = true;
+		tph[0] = false;
+		tpop[0] = false;
+		tval[0] = din;
+		tpos[0] = ++count;
+	} else if (pop) {
+		tv[0] = true;
+		tph[0] = false;
+		tpop[0] = true;
+		tpos[0] = 1;
+	}
+	if (clr) {
+		for (int l = 0; l < LEVELS; l++)
+			tv[l] = false;
+		count = 0;
+		top_r = EMPTY;
+	}
+}
+
+SortCoreModel::SortCoreModel(bool free_running, int net_lanes, int key_width, bool index,
+		int sel_lanes, int radix_bits, bool host_bank)
+		: heap(key_width + (index ? 13 : 0)) {
+	std::fill(&bank[0][0], &bank[0][0] + 3 * MEM_SIZE, 0);
+	std::fill(dout_a, dout_a + 3, 0);
+	std::fill(dout_b, dout_b + 3, 0);
+	cur = cur_r = 0;
+	oth = 1;
+	hst = hst_r = 2;
+	db = false;
+	ie = irq_pend = done_r = false;
+	icount = jcount = 0;
+	jd = minidx = 0;
+	minv = 0;
+	found = false;
+	w = lo = mi = mj = mk = mid = hi = 0;
+	this->radix_bits = radix_bits;
+	passes = (key_width + radix_bits - 1) / radix_bits;
+	rc = 0;
+	rpass = 0;
+	rv1 = rv2 = rv3 = rpv1 = false;
+	rd2 = rd3 = rb1 = 0;
+	re2 = 0;
+	rc3 = racc = rdouta = 0;
+	std::fill(rcnt, rcnt + 256, 0);
+	std::fill(rmap, rmap + 256, false);
+	rm = rg = rkk = 0;
+	rsel_b = rsel_base = rsel_cnt = rwp = 0;
+	state = S0;
+	s = WrInit_r = Rd_r = false;
+	std::fill(hist, hist + 256, 0);
+	hist_b = 0;
+	hist_r = 0;
+	gen_run = gen_byte = false;
+	gen_pat = 0;
+	gen_lfsr = 0xACE1;
+	gen_i = 0;
+	gen_div = 0;
+	chk_cnt_in = chk_cnt_out = 0;
+	chk_sum_in = chk_sum_out = chk_xor_in = chk_xor_out = 0;
+	chk_last = 0;
+	chk_have_last = chk_bad = false;
+	alg = SortCore::ALG_SELECTION;
+	n_reg = k_reg = 0;
+	ri = 0;
+	pk_pend = pk_phase = pk_rd_phase = pk_rd_valid = false;
+	pk_pend_addr = pk_pend_d2 = pk_pend_d3 = 0;
+	rbuf[0] = rbuf[1] = rbuf[2] = rbuf[3] = 0;
+	win_rd_r = false;
+	this->key_width = key_width;
+	this->index = index;
+	this->net_lanes = net_lanes;
+	net_remaining = 0;
+	this->sel_lanes = sel_lanes;
+	banked = !net_lanes && sel_lanes > 1;
+	hb = !net_lanes && !banked && host_bank;
+	this->free_running = free_running;
+	time = 0;
+	start_time = 0;
+	cycles = writes = 0;
+}
+
+uint64_t SortCoreModel::last_sort_cycles() {
+	return cycles;
+}
+
+uint64_t SortCoreModel::last_sort_writes() {
+	return writes;
+}
+
+// element word: key, then the 13-bit address with INDEX
+uint64_t SortCoreModel::word(uint32_t key, uint16_t addr) {
+	uint64_t k = key & (uint32_t) (((uint64_t) 1 << key_width) - 1);
+	return index ? k << 13 | addr : k;
+}
+
+uint32_t SortCoreModel::key_of(uint64_t w) {
+	return (uint32_t) (index ? w >> 13 : w);
+}
+
+uint32_t SortCoreModel::index_of(uint64_t w) {
+	return index ? (uint32_t) (w & ADDR_MASK) : 0;
+}
+
+uint32_t SortCoreModel::clock(bool wr, bool rd, int addr, uint32_t wr_data, bool win) {
+	/* memory window (win_cs) or MMIO decode (cs is implied by the slot dispatch) */
+	bool WinWr = win && wr, WinRd = win && rd;
+	if (win) wr = rd = false;
+	int a = addr & 0x1F;
+	bool WrN = wr && a == 2;
+	bool WrK = wr && a == 14;
+	bool WrGen = wr && a == 15;
+	bool Wrs = wr && a == 3 && !(wr_data & 0x02);
+	bool Wrl = wr && a == 3 && (wr_data & 0x03) == 0x02;
+	bool WrMem = wr && a == 0;
+	bool RdMem = rd && a == 1;
+	bool RdStatus = rd && a == 4;
+	bool WrP2 = wr && a == 5;
+	bool RdP2 = rd && a == 6;
+	bool WrP4 = wr && a == 7;
+	bool RdP4 = rd && a == 8;
+	bool WrBank = wr && a == 9;
+	bool WrIrq = wr && a == 10;
+	bool RdKey = rd && a == 11;
+	bool RdIdx = rd && a == 12;
+	bool RdHist = rd && a == 13;
+	bool WrAddr = wr && a == 16;
+	bool RdAddr = rd && a == 16;
+	bool WrData = wr && a == 17;
+	bool RdData = rd && a == 17;
+	bool hswap = WrBank && (wr_data & 0x02) && !s && hb;
+	bool WrInit = WrInit_r && WrMem;
+
+	/* dual_bank_RAM output multiplexers */
+	uint64_t douta = dout_a[cur_r], doutb = dout_b[cur_r];
+	bool host_bank = hb && db;
+	uint64_t hosta = host_bank ? dout_a[hst_r] : douta;
+	uint64_t hostb = host_bank ? dout_b[hst_r] : doutb;
+
+	/* datapath status */
+	uint16_t n13 = n_reg & ADDR_MASK;
+	uint32_t n_eff = n13 ? n13 : (uint32_t) MEM_SIZE;
+	uint64_t cur_min = found ? minv : douta;
+	bool MigtMj = cur_min > doutb;
+	bool zi = icount == i_last();
+	bool zj = jd == ((n13 - 1) & ADDR_MASK);
+	/* merge_counters */
+	uint32_t lo2w = lo + 2 * w;
+	uint32_t mid_c = std::min(lo + w, n_eff);
+	uint32_t hi_c = std::min(lo2w, n_eff);
+	bool take = mi < mid && (mj >= hi || !MigtMj);
+	bool zk = mk + 1 == hi;
+	bool zlo = lo2w >= n_eff;
+	bool zw = 2 * w >= n_eff;
+	/* radix_counters */
+	uint32_t rmask = (1u << radix_bits) - 1;
+	bool zc = rc == rm + 1;
+	bool zb = rc == rmask + 1;
+	bool zp = rpass == passes - 1;
+
+	/* controller outputs and next state */
+	bool Done = false, Wr = false, Li = false, Ei = false, Lj = false, Ej = false, Emin = false;
+	bool Lw = false, Lp = false, Em = false, Enp = false, Ew = false;
+	bool Lr = false, Rc = false, Rp = false, Rs = false, Lc = false, Enr = false;
+	ctrl_state next_state = state;
+	if (net_lanes || banked) {
+		// network_controller (or controller on Banked_datapath): the sort
+		// is applied when s rises, the busy states only count down the latency
+		switch (state) {
+		case S0:
+			if (s && banked && (alg == SortCore::ALG_STREAM || alg == SortCore::ALG_HIST)) {
+				next_state = S4;
+			} else if (s) {
+				net_remaining = net_lanes ? network_sort() : banked_sort();
+				next_state = net_remaining ? S1 : S4;
+			}
+			break;
+		case S4:
+			Done = true;
+			next_state = s ? S4 : S0;
+			break;
+		default:
+			if (--net_remaining == 0)
+				next_state = S4;
+			break;
+		}
+	} else {
+		switch (state) {
+		case S0:
+			Li = true;
+			Ei = true;
+			Lw = true;
+			Lr = true;
+			if (s)
+				next_state = (alg == SortCore::ALG_MERGE) ? M1 :
+						(alg == SortCore::ALG_RADIX || alg == SortCore::ALG_SELECT) ? R1 :
+						(alg == SortCore::ALG_STREAM || alg == SortCore::ALG_HIST || n13 == 1) ? S4 : S1;
+			break;
+		case S1:
+			Lj = true;
+			Ej = true;
+			next_state = S2;
+			break;
+		case S2:
+			Emin = MigtMj;
+			Ej = true;
+			next_state = zj ? S3 : S2;
+			break;
+		case S3:
+			Wr = true;
+			if (!zi) {
+				Ei = true;
+				next_state = S1;
+			} else {
+				next_state = S4;
+			}
+			break;
+		case S4:
+			Done = true;
+			next_state = s ? S4 : S0;
+			break;
+		case M1:
+			Lp = true;
+			next_state = M2;
+			break;
+		case M2:
+			Em = true;
+			if (zk) {
+				if (!zlo) {
+					Enp = true;
+					next_state = M1;
+				} else {
+					Ew = true;
+					next_state = zw ? S4 : M1;
+				}
+			}
+			break;
+		case R1:
+			Rc = true;
+			if (zc) {
+				Lc = true;
+				next_state = R2;
+			}
+			break;
+		case R2:
+			Rp = true;
+			if (zb) {
+				Lc = true;
+				next_state = R3;
+			}
+			break;
+		case R3:
+			Rs = true;
+			if (zc) {
+				Lc = true;
+				Ew = true;
+				if (zp) {
+					next_state = S4;
+				} else {
+					Enr = true;
+					next_state = R1;
+				}
+			}
+			break;
+		}
+	}
+
+	/* read data multiplexers (addr_ctrl = addr(2)) */
+	uint32_t rd_data = 0;
+	bool chk_match = chk_cnt_in == chk_cnt_out && chk_sum_in == chk_sum_out &&
+			chk_xor_in == chk_xor_out;
+	if (RdAddr)
+		rd_data = ri;
+	else if (RdData)
+		rd_data = key_of(rbuf[0]);
+	else if (RdStatus)
+		rd_data = key_width << 8 | (net_lanes ? 0 : 0x80) | (gen_run ? 0x40 : 0) | (chk_match ? 0x20 : 0) | (chk_bad ? 0 : 0x10) |
+				(index ? 0x08 : 0) | (irq_pend ? 0x04 : 0) | (hb ? 0x02 : 0) | Done;
+	else if (Rd_r && (RdMem || RdKey))
+		rd_data = key_of(rbuf[0]);
+	else if (Rd_r && RdIdx)
+		rd_data = index_of(rbuf[0]);
+	else if (Rd_r && RdP2)
+		rd_data = (key_of(rbuf[1]) & 0xFFFF) << 16 | (key_of(rbuf[0]) & 0xFFFF);
+	else if (Rd_r && RdP4)
+		rd_data = (key_of(rbuf[3]) & 0xFF) << 24 | (key_of(rbuf[2]) & 0xFF) << 16 |
+				(key_of(rbuf[1]) & 0xFF) << 8 | (key_of(rbuf[0]) & 0xFF);
+
+	/* check_unit: keys of the read, ascending positions */
+	uint32_t ck[4];
+	int nk = 0;
+	if (win_rd_r) {
+		ck[0] = key_of(hosta); // MEM[win_addr], sampled by the bus now
+		nk = 1;
+	} else if (Rd_r && (RdMem || RdIdx)) {
+		ck[0] = (!net_lanes && alg == SortCore::ALG_STREAM) ? key_of(heap.top()) :
+				(alg == SortCore::ALG_HIST) ? hist_b & 0xFF : key_of(rbuf[0]);
+		nk = 1;
+	} else if (Rd_r && RdP2) {
+		for (nk = 0; nk < 2; nk++)
+			ck[nk] = key_of(rbuf[nk]) & 0xFFFF;
+	} else if (Rd_r && RdP4) {
+		for (nk = 0; nk < 4; nk++)
+			ck[nk] = key_of(rbuf[nk]) & 0xFF;
+	}
+	win_rd_r = WinRd;
+
+	/* gen_unit: element i of the pattern (one every 4 clocks into the heap) */
+	uint16_t gen_last = (n_reg - 1) & ADDR_MASK;
+	uint16_t gen_nxt = (uint16_t) ((gen_lfsr >> 1) |
+			(((gen_lfsr ^ (gen_lfsr >> 2) ^ (gen_lfsr >> 3) ^ (gen_lfsr >> 5)) & 1) << 15));
+	uint16_t gen_val = gen_pat == 1 ? (uint16_t) ((gen_last - gen_i) & ADDR_MASK) :
+			gen_pat == 2 ? gen_i : gen_pat == 3 ? gen_nxt & 0x0003 : gen_nxt;
+	bool gen_we = gen_run && (net_lanes || alg != SortCore::ALG_STREAM || (gen_div & 3) == 3);
+	uint32_t pk_data = gen_run ? (gen_byte ? gen_val & 0xFF : gen_val) : wr_data;
+
+	/* pack_unit: host ports of the memory */
+	bool W1 = WrInit || gen_we || WrData;
+	bool W2 = WrInit_r && WrP2, W4 = WrInit_r && WrP4;
+	bool wr_any = W1 || W2 || W4 || WinWr;
+	uint16_t pa = pk_pend ? pk_pend_addr : (WinWr || WinRd) ? addr & ADDR_MASK :
+			wr_any ? ri : (ri + (pk_phase ? 2 : 0)) & ADDR_MASK;
+	uint16_t HAddrA = pa, HAddrB = (pa + 1) & ADDR_MASK;
+	uint32_t keyA = pk_pend ? pk_pend_d2 : W4 ? pk_data & 0xFF : W2 ? pk_data & 0xFFFF : pk_data;
+	uint32_t keyB = pk_pend ? pk_pend_d3 : W4 ? (pk_data >> 8) & 0xFF : pk_data >> 16;
+	uint64_t HDinA = word(keyA, HAddrA), HDinB = word(keyB, HAddrB);
+	bool HWeA = wr_any || pk_pend, HWeB = W2 || W4 || pk_pend;
+	if (pk_rd_valid) {
+		rbuf[pk_rd_phase ? 2 : 0] = hosta;
+		rbuf[pk_rd_phase ? 3 : 1] = hostb;
+	}
+	pk_rd_valid = !(wr_any || pk_pend || WinRd);
+	pk_rd_phase = pk_phase;
+	pk_phase = !pk_phase;
+	pk_pend = W4;
+	if (W4) {
+		pk_pend_addr = (ri + 2) & ADDR_MASK;
+		pk_pend_d2 = (wr_data >> 16) & 0xFF;
+		pk_pend_d3 = wr_data >> 24;
+	}
+
+	/* stream_heap */
+	bool stream = !net_lanes && alg == SortCore::ALG_STREAM;
+	if (stream && (RdMem || RdKey))
+		rd_data = key_of(heap.top());
+	else if (stream && RdIdx)
+		rd_data = index_of(heap.top());
+	if (!net_lanes)
+		heap.clock((Wrl && (wr_data & 0x04)) || WrGen, stream && (WrInit || gen_we), stream && Rd_r && (RdMem || RdIdx), HDinA);
+
+	/* hist_unit */
+	bool hist_mode = alg == SortCore::ALG_HIST;
+	if (hist_mode && RdMem)
+		rd_data = hist_b & 0xFF;
+	else if (RdHist)
+		rd_data = hist[ri & 0xFF];
+	if ((Wrl && (wr_data & 0x04)) || WrGen) {
+		std::fill(hist, hist + 256, 0);
+		hist_r = 0;
+	} else if (Wrl) {
+		hist_seek(0); // init_read
+	}
+	if (HWeA) hist[key_of(HDinA) & 0xFF]++;
+	if (HWeB) hist[key_of(HDinB) & 0xFF]++;
+	if (hist_mode && Rd_r && RdMem && hist_r && --hist_r == 0)
+		hist_seek(hist_b + 1);
+
+	/* check_unit */
+	if (HWeA) {
+		chk_cnt_in++;
+		chk_sum_in += key_of(HDinA);
+		chk_xor_in ^= key_of(HDinA);
+	}
+	if (HWeB) {
+		chk_cnt_in++;
+		chk_sum_in += key_of(HDinB);
+		chk_xor_in ^= key_of(HDinB);
+	}
+	for (int i = 0; i < nk; i++) {
+		if ((i == 0 && chk_have_last && chk_last > ck[0]) || (i > 0 && ck[i - 1] > ck[i]))
+			chk_bad = true;
+		chk_cnt_out++;
+		chk_sum_out += ck[i];
+		chk_xor_out ^= ck[i];
+	}
+	if (nk) {
+		chk_last = ck[nk - 1];
+		chk_have_last = true;
+	}
+	if ((Wrl && (wr_data & 0x04)) || WrGen) {
+		chk_cnt_in = 0;
+		chk_sum_in = chk_xor_in = 0;
+	} else if (Wrl) {
+		chk_cnt_out = 0;
+		chk_sum_out = chk_xor_out = 0;
+		chk_have_last = chk_bad = false;
+	}
+
+	/* gen_unit registers */
+	gen_div++;
+	if (WrGen) {
+		gen_run = true;
+		gen_pat = wr_data & 0x03;
+		gen_byte = wr_data & 0x04;
+		gen_lfsr = (wr_data >> 16) ? (uint16_t) (wr_data >> 16) : 0xACE1;
+		gen_i = 0;
+		gen_div = 0;
+	} else if (gen_we) {
+		gen_lfsr = gen_nxt;
+		if (gen_i == gen_last) gen_run = false;
+		gen_i = (gen_i + 1) & ADDR_MASK;
+	}
+
+	/* phase strobes (timer capture registers) */
+	if (free_running) {
+		if ((Wrl && (wr_data & 0x04)) || WrGen) host_capture(SortCore::CAP_LOAD_START, time);
+		if (HWeA || HWeB) host_capture(SortCore::CAP_LOAD_END, time);
+		if (Wrs && (wr_data & 0x01) && !s) host_capture(SortCore::CAP_SORT_START, time);
+		if (Done && !done_r) host_capture(SortCore::CAP_SORT_DONE, time);
+		if (Wrl && !(wr_data & 0x04)) host_capture(SortCore::CAP_READ_START, time);
+		if (nk) host_capture(SortCore::CAP_READ_END, time);
+	}
+
+	/* Done interrupt */
+	if (WrIrq) ie = wr_data & 0x01;
+	if (Done && !done_r) irq_pend = true;
+	else if (WrIrq) irq_pend = false;
+	done_r = Done;
+
+	if ((net_lanes || banked) && s) {
+		// banks belong to the network/banked engine; host port idle
+		time++;
+		if (next_state == S4 && state != S4)
+			cycles = time - start_time;
+		state = next_state;
+		if (Wrs) s = wr_data & 0x01;
+		if (WrN) n_reg = (uint16_t) wr_data;
+		if (WrK) k_reg = (uint16_t) wr_data;
+		if (Wrl) {
+			WrInit_r = wr_data & 0x04;
+			Rd_r = !(wr_data & 0x04);
+		}
+		return rd_data;
+	}
+
+	/* RAM port multiplexers */
+	bool merge = alg == SortCore::ALG_MERGE;
+	bool rsel = alg == SortCore::ALG_SELECT;
+	bool radix = alg == SortCore::ALG_RADIX || rsel;
+	uint32_t inext = Lp ? lo : (Em && take) ? mi + 1 : mi;
+	uint32_t jnext = Lp ? mid_c : (Em && !take) ? mj + 1 : mj;
+	bool eng = s || host_bank; // engine owns the current bank
+	uint16_t AddrA = !eng ? HAddrA : merge ? inext & ADDR_MASK : radix ? (rg + rc) & ADDR_MASK : icount;
+	bool Wsw = Wr && found; // swap write
+	uint64_t dina = eng ? minv : HDinA;
+	bool wea = eng ? Wsw : HWeA;
+	uint16_t AddrB = !eng ? HAddrB : merge ? jnext & ADDR_MASK : Wr ? minidx :
+			Lj ? (icount + 1) & ADDR_MASK : jcount;
+	uint64_t dinb = eng ? douta : HDinB;
+	bool web = eng ? Wsw : HWeB;
+	/* radix_counters: digit of Mi, forwarded or counted counter */
+	int rpos = rsel ? passes - 1 - rpass : rpass; // MSD first for ALG_SELECT
+	uint32_t dg = (uint32_t) (((uint64_t) key_of(douta) >> (rpos * radix_bits)) & rmask);
+	uint32_t rcount = rmap[rb1] ? rdouta : 0;
+	uint32_t rcur = (rv3 && rd3 == rd2) ? rc3 : (Rc && !rmap[rd2]) ? 0 : rdouta;
+	bool keep = Rs && rv2 && rsel && rd2 == rsel_b;
+	uint16_t AddrC = rsel ? (rg + rsel_base + rwp) & ADDR_MASK : radix ? rcur & ADDR_MASK : mk & ADDR_MASK;
+	uint64_t dinc = radix ? re2 : take ? douta : doutb;
+	bool wec = Em || (rsel ? keep : Rs && rv2);
+
+	/* rising edge: RAM ports (NO_CHANGE: output holds during a write) */
+	uint64_t *cb = bank[cur], *ob = bank[oth], *hbank = bank[hst];
+	if (wea) cb[AddrA] = dina;
+	else dout_a[cur] = cb[AddrA];
+	if (web) cb[AddrB] = dinb;
+	else dout_b[cur] = cb[AddrB];
+	if (wec) ob[AddrC] = dinc;
+	else dout_a[oth] = ob[AddrC];
+	dout_b[oth] = ob[AddrB];
+	if (host_bank && HWeA) hbank[HAddrA] = HDinA;
+	else dout_a[hst] = hbank[HAddrA];
+	if (host_bank && HWeB) hbank[HAddrB] = HDinB;
+	else dout_b[hst] = hbank[HAddrB];
+	cur_r = cur;
+	hst_r = hst;
+	if (Ew) std::swap(cur, oth);
+	else if (hswap) std::swap(cur, hst);
+	if (WrBank && hb) db = wr_data & 0x01;
+	if (Wsw || wec) writes++;
+	uint32_t raddr = Rp ? rc & rmask : dg;
+	if (rpv1) rcnt[rb1] = racc;
+	else if (rv2) rcnt[rd2] = rcur + 1;
+	rdouta = rcnt[raddr];
+
+	/* rising edge: counters */
+	uint16_t icount_old = icount;
+	if (Ei) icount = Li ? 0 : (icount + 1) & ADDR_MASK;
+	if (Ej) jcount = Lj ? (icount_old + 2) & ADDR_MASK : (jcount + 1) & ADDR_MASK;
+	uint16_t jd_old = jd;
+	jd = AddrB;
+	if (Li || Lj) {
+		found = false;
+	} else if (Emin) {
+		found = true;
+		minv = doutb;
+		minidx = jd_old;
+	}
+	if (Wrl || WrGen) ri = 0;
+	else if (WrAddr) ri = wr_data & ADDR_MASK;
+	else if (WrMem || RdMem || RdIdx || RdHist || gen_we) ri = (ri + 1) & ADDR_MASK;
+	else if (WrP2 || RdP2) ri = (ri + 2) & ADDR_MASK;
+	else if (WrP4 || RdP4) ri = (ri + 4) & ADDR_MASK;
+	if (Lw) {
+		w = 1;
+		lo = 0;
+	} else if (Ew) {
+		w *= 2;
+		lo = 0;
+	} else if (Enp) {
+		lo = lo2w;
+	}
+	uint32_t rc_old = rc;
+	if (Lr || Lc) rc = 0;
+	else if (Rc || Rp || Rs) rc++;
+	if (Lr) rpass = 0;
+	else if (Enr) rpass++;
+	bool rv1_old = rv1, rv2_old = rv2;
+	uint32_t rd2_old = rd2;
+	rv1 = (Rc || Rs) && rc_old < rm;
+	rv2 = rv1_old;
+	rd2 = dg;
+	re2 = douta;
+	rv3 = rv2_old;
+	rd3 = rd2_old;
+	rc3 = rcur + 1;
+	bool rpv1_old = rpv1;
+	rpv1 = Rp && rc_old <= rmask;
+	uint32_t rb1_old = rb1;
+	rb1 = rc_old & rmask;
+	uint32_t racc_old = racc;
+	if (Rc) racc = 0;
+	else if (rpv1_old) racc += rcount;
+	if (rpv1_old && rkk >= racc_old && rkk < racc_old + rcount) {
+		rsel_b = rb1_old;
+		rsel_base = racc_old;
+		rsel_cnt = rcount;
+	}
+	if (Rp) rwp = 0;
+	else if (keep) rwp++;
+	if (Lr) {
+		uint32_t k13 = k_reg & ADDR_MASK;
+		rm = n_eff;
+		rg = 0;
+		rkk = (k13 == 0 || k13 > n_eff) ? n_eff - 1 : k13 - 1;
+	} else if (Enr && rsel) {
+		rm = rsel_cnt;
+		rg += rsel_base;
+		rkk -= rsel_base;
+	}
+	if (Lr || Enr) std::fill(rmap, rmap + 256, false);
+	else if (Rc && rv2_old) rmap[rd2_old] = true;
+	if (Lp) {
+		mi = lo;
+		mj = mid_c;
+		mk = lo;
+		mid = mid_c;
+		hi = hi_c;
+	} else if (Em) {
+		mk++;
+		if (take) mi++;
+		else mj++;
+	}
+
+	/* rising edge: controller and wrapper registers */
+	if (next_state == S4 && state != S4)
+		cycles = time + 1 - start_time;
+	state = next_state;
+	if (Wrs) {
+		if ((wr_data & 0x01) && !s) {
+			start_time = time + 1;
+			writes = 0;
+		}
+		s = wr_data & 0x01;
+	}
+	if (Wrs || Wrl) alg = (wr_data & SortCore::ALG_MASK) >> SortCore::ALG_SHIFT;
+	if (WrN) n_reg = (uint16_t) wr_data;
+	if (WrK) k_reg = (uint16_t) wr_data;
+	if (Wrl) {
+		WrInit_r = wr_data & 0x04;
+		Rd_r = !(wr_data & 0x04);
+	}
+	time++;
+	return rd_data;
+}
+
+// icounter zi: i = N-2, or K-1 for a partial sort (0 < K < N-1)
+uint16_t SortCoreModel::i_last() {
+	uint16_t n13 = n_reg & ADDR_MASK, k13 = k_reg & ADDR_MASK;
+	if (k13 && k13 < ((n13 - 1) & ADDR_MASK))
+		return k13 - 1;
+	return (n13 - 2) & ADDR_MASK;
+}
+
+// hist_unit emitter: next counted bucket >= from (priority encoder)
+void SortCoreModel::hist_seek(int from) {
+	for (int b = from; b < 256; b++) {
+		if (hist[b]) {
+			hist_b = b;
+			hist_r = hist[b];
+			return;
+		}
+	}
+	hist_r = 0; // E_IDLE, top keeps the last bucket
+}
+
+// clock the idle bus up to the emulated time of the host
+void SortCoreModel::sync() {
+	if (!free_running)
+		return;
+	uint64_t target = host_cycles();
+	int idle = 0;
+	while (time < target) {
+		clock(false, false, 0, 0);
+		// nothing changes in S0 (s=0) or S4 once the RAM outputs and the
+		// pack_unit read-ahead buffer settled and the stream heap is idle
+		if (++idle >= 3 && ((state == S0 && !s) || state == S4) && !heap.busy() && !gen_run)
+			time = target;
+	}
+}
+
+bool SortCoreModel::irq_armed() {
+	return ie;
+}
+
+bool SortCoreModel::irq() {
+	sync();
+	return ie && irq_pend;
+}
+
+// a sort in flight raises irq one clock after Done
+bool SortCoreModel::run_to_irq() {
+	sync();
+	if (!ie || !s) return irq_pend && ie;
+	uint64_t ran = run_to_done();
+	clock(false, false, 0, 0);
+	if (free_running) host_stall(ran + 1);
+	return irq_pend;
+}
+
+// clock the idle bus until the controller reaches S4
+uint64_t SortCoreModel::run_to_done() {
+	uint64_t t0 = time;
+	while (s && state != S4)
+		clock(false, false, 0, 0);
+	return time - t0;
+}
+
+uint32_t SortCoreModel::read(int reg) {
+	sync();
+	if (reg == 4 && s && state != S4) {
+		// the driver busy-waits on Done; skip ahead instead of spinning
+		uint64_t ran = run_to_done();
+		if (free_running) host_stall(ran);
+	}
+	return clock(false, true, reg, 0);
+}
+
+void SortCoreModel::write(int reg, uint32_t data) {
+	sync();
+	clock(true, false, reg, data);
+}
+
+// host port A at addr; the RAM output holds MEM[addr] on the next clock,
+// when the bus samples it
+uint32_t SortCoreModel::win_read(int addr) {
+	sync();
+	clock(false, true, addr, 0, true);
+	bool host_bank = hb && db;
+	return key_of(host_bank ? dout_a[hst_r] : dout_a[cur_r]);
+}
+
+void SortCoreModel::win_write(int addr, uint32_t data) {
+	sync();
+	clock(true, false, addr, data, true);
+}
+
+// Network_datapath passes on the memory; returns the clocks spent in
+// S1/S2 of network_controller
+uint64_t SortCoreModel::network_sort() {
+	uint64_t *ram = bank[cur];
+	uint64_t ones = ((uint64_t) 1 << (key_width + (index ? 13 : 0))) - 1;
+	int n13 = n_reg & ADDR_MASK;
+	int n_eff = n13 ? n13 : MEM_SIZE;
+	int lgN = 0;
+	while ((1 << lgN) < n_eff)
+		lgN++;
+	int size = 1 << lgN;
+	uint64_t rows = std::max(1, size / (2 * net_lanes));
+
+	for (int lgk = 1; lgk <= lgN; lgk++) {
+		for (int lgj = lgk - 1; lgj >= 0; lgj--) {
+			for (int i = 0; i < size; i++) {
+				int l = i ^ (1 << lgj);
+				if (l < i)
+					continue;
+				// first pass: elements N..2^lgN-1 read as all ones
+				uint64_t a = (lgk == 1 && i >= n_eff) ? ones : ram[i];
+				uint64_t b = (lgk == 1 && l >= n_eff) ? ones : ram[l];
+				bool asc = !(i & (1 << lgk));
+				bool swap = asc ? a > b : !(a > b);
+				ram[i] = swap ? b : a;
+				ram[l] = swap ? a : b;
+			}
+			writes += rows;
+		}
+	}
+	return 2 * rows * (uint64_t) (lgN * (lgN + 1) / 2);
+}
+
+// Banked_datapath selection sort on the memory; returns the clocks spent
+// in S1..S3 of the controller (S1, one clock per row, S3 per outer iteration)
+uint64_t SortCoreModel::banked_sort() {
+	uint64_t *ram = bank[cur];
+	int n13 = n_reg & ADDR_MASK;
+	int n_eff = n13 ? n13 : MEM_SIZE;
+	int lg = 0;
+	while ((1 << lg) < sel_lanes)
+		lg++;
+	int row_last = (n_eff - 1) >> lg;
+	uint64_t clocks = 0;
+
+	int last = i_last();
+	for (int i = 0; i + 1 < n_eff && i <= last; i++) {
+		clocks += 3 + row_last - ((i + 1) >> lg);
+		// first occurrence of the strict minimum (lower lane wins ties)
+		int m = i;
+		for (int j = i + 1; j < n_eff; j++)
+			if (ram[m] > ram[j]) m = j;
+		if (m != i) {
+			std::swap(ram[i], ram[m]);
+			writes++;
+		}
+	}
+	return clocks;
+}
+
+uint64_t SortCoreModel::predict(const uint16_t *data, int n, uint64_t *writes, int net_lanes, int alg,
+		int sel_lanes, int radix_bits) {
+	SortCoreModel *m = new SortCoreModel(false, net_lanes, 16, false, sel_lanes, radix_bits);
+	uint32_t mode = (alg << SortCore::ALG_SHIFT) & SortCore::ALG_MASK;
+	uint64_t c;
+
+	// same access sequence as SortCore: set_algorithm(), set_n(), init_write(), write(), sort(), done()
+	m->write(2, (uint32_t) n);
+	m->write(3, mode);
+	m->write(3, mode | 0x06);
+	for (int i = 0; i < n; i++)
+		m->write(0, data[i]);
+	m->write(3, mode | 0x01);
+	m->read(4);
+	c = m->cycles;
+	if (writes) *writes = m->writes;
+	delete m;
+	return c;
+}
+
+#endif  // _HOST_EMU
@@ -0,0 +1,222 @@
+/* -----------------------------------------------------------------------------
+ * Project: High-Performance FPGA Hardware Accelerator
+ * File: sort_core_model.h
+ * Author: Kainoa Asse
+ * Description:
+ * Cycle-accurate C++ model of chu_sorting_core for the _HOST_EMU build and
+ * for offline throughput prediction. Implements the same MMIO register map
+ * as SortCore (MEMW_ri_REG, MEMR_ri_REG, N_REG, CTRL_REG, STATUS_REG).
+ *
+ * Every call to clock() is one rising edge of the RTL:
+ *  - controller.vhd: S0..S4 FSM (S2: one selection sort comparison per
+ *    clock, S3: one swap per outer iteration), the M1/M2 merge sort
+ *    states and the R1..R3 radix sort states
+ *  - Sorting_datapath.vhd: dual_bank_RAM (synchronous read, NO_CHANGE,
+ *    current/other/host bank roles),
+ *    icounter, jcounter, running minimum, merge_counters, radix_counters,
+ *    Comparator and the s/Rd/Done multiplexers
+ *  - stream_heap.vhd: level RAMs and token pipeline (StreamHeapModel)
+ *  - hist_unit.vhd: bucket counters and the counting sort readback
+ *    (functional: counts are updated on the write, not through the queue)
+ *  - gen_unit.vhd: LFSR/descending/ascending/few-unique test data written
+ *    through host port A, one element per clock
+ *  - check_unit.vhd: count/sum/XOR of the keys loaded and read back, order
+ *    of the keys read back
+ *  - pack_unit.vhd: host ports, packed writes, the read-ahead buffer and
+ *    the memory window (win_read()/win_write(), video slot V4_USER4)
+ *  - chu_sorting_core.vhd: s/N/WrInit/Rd/alg registers, ri counter, the
+ *    Done interrupt, the phase strobes (host_capture()) and the MMIO decode (one bus access = one clock with the strobe asserted)
+ * Element words are KEY_WIDTH bits, plus the 13-bit load address below the
+ * key when INDEX is set (uint64_t holds up to 32 + 13 bits).
+ * With net_lanes > 0 the model is built like chu_sorting_core with
+ * NET_LANES > 0: network_controller latency is replayed per clock and the
+ * Network_datapath bitonic passes (with first-pass padding) are applied
+ * to the memory when s rises. sel_lanes > 1 (Banked_datapath) is handled
+ * the same way: the selection sort is applied when s rises and the
+ * controller latency (one row of sel_lanes elements per clock) replayed.
+ * When attached to the host bus the model catches up with host_cycles()
+ * before each access; a STATUS_REG poll while sorting clocks the FSM to
+ * Done and stalls the emulated clock by the same amount.
+ * -----------------------------------------------------------------------------
+ */
+
+#ifndef _SORT_CORE_MODEL_H_INCLUDED
+#define _SORT_CORE_MODEL_H_INCLUDED
+
+#ifdef _HOST_EMU
+
+#include "host_emu.h"
+
+#ifndef HOST_NET_LANES
+#define HOST_NET_LANES 0 // NET_LANES generic of the emulated chu_sorting_core
+#endif
+#ifndef HOST_SEL_LANES
+#define HOST_SEL_LANES 1 // SEL_LANES generic (Banked_datapath when > 1)
+#endif
+#ifndef HOST_KEY_WIDTH
+#define HOST_KEY_WIDTH 16 // KEY_WIDTH generic (8..32)
+#endif
+#ifndef HOST_INDEX
+#define HOST_INDEX 0 // INDEX generic: element words carry their load address
+#endif
+#ifndef HOST_RADIX_BITS
+#define HOST_RADIX_BITS 8 // RADIX_BITS generic: digit of ALG_RADIX (8 or 4)
+#endif
+#ifndef HOST_DB_BANK
+#define HOST_DB_BANK 0 // HOST_BANK generic: third bank for double buffering (BANK_REG)
+#endif
+
+/* stream_heap.vhd: pipelined min-heap of the ALG_STREAM mode */
+class StreamHeapModel {
+public:
+	enum {
+		LEVELS = 14, // positions 1 .. 2^13
+	};
+	StreamHeapModel(int data_width = 16);
+	void clock(bool clr, bool push, bool pop, uint64_t din); // one rising edge
+	uint64_t top();   // smallest element (top register)
+	bool busy();      // tokens in flight
+
+private:
+	uint64_t EMPTY;   // bit DATA_WIDTH: empty node
+	uint64_t ram[LEVELS][1 << (LEVELS - 2)]; // level l uses 2^l words (last: 2)
+	uint64_t douta[LEVELS], doutb[LEVELS];
+	bool tv[LEVELS], tph[LEVELS], tpop[LEVELS];
+	uint64_t tval[LEVELS], top_r;
+	uint32_t tpos[LEVELS], count;
+};
+
+class SortCoreModel : public HostDevice {
+public:
+	enum {
+		MEM_SIZE = 8192, // 2^13 words, as RAM.vhd
+		ADDR_MASK = 0x1FFF // 13-bit counters
+	};
+
+	/* controller.vhd states */
+	enum ctrl_state {
+		S0, S1, S2, S3, S4, M1, M2, R1, R2, R3
+	};
+
+	/**
+	 * constructor.
+	 * @param free_running true: follow the emulated clock of the host bus;
+	 *        false: offline instance, time advances only with accesses
+	 * @param net_lanes NET_LANES generic (0: Sorting_datapath)
+	 * @param key_width KEY_WIDTH generic (8..32)
+	 * @param index INDEX generic
+	 * @param sel_lanes SEL_LANES generic (1: Sorting_datapath)
+	 * @param radix_bits RADIX_BITS generic (digit of ALG_RADIX, 1..8)
+	 * @param host_bank HOST_BANK generic (third bank, BANK_REG)
+	 */
+	SortCoreModel(bool free_running = true, int net_lanes = 0,
+			int key_width = 16, bool index = false, int sel_lanes = 1,
+			int radix_bits = 8, bool host_bank = false);
+	uint32_t read(int reg);
+	void write(int reg, uint32_t data);
+	uint32_t win_read(int addr);  // key of MEM[addr] through the memory window
+	void win_write(int addr, uint32_t data);
+	bool irq_armed();  // IRQ_REG enable bit
+	bool irq();        // irq output of chu_sorting_core
+	bool run_to_irq(); // clock the idle bus to the Done interrupt
+
+	uint64_t last_sort_cycles(); // clocks from s=1 to Done of the last sort
+	uint64_t last_sort_writes(); // BRAM write cycles (swaps) of the last sort
+
+	/**
+	 * predict the sort latency of one data set offline
+	 * @param data values to sort (loaded through MEMW_ri_REG)
+	 * @param n number of values (N_REG)
+	 * @param writes optional; returns the number of swap cycles
+	 * @param net_lanes NET_LANES generic (0: Sorting_datapath)
+	 * @param alg algorithm select field of CTRL_REG (SortCore::ALG_*)
+	 * @param sel_lanes SEL_LANES generic (1: Sorting_datapath)
+	 * @param radix_bits RADIX_BITS generic
+	 * @return clocks from s=1 to Done
+	 */
+	static uint64_t predict(const uint16_t *data, int n, uint64_t *writes,
+			int net_lanes = 0, int alg = 0, int sel_lanes = 1, int radix_bits = 8);
+
+private:
+	/* Sorting_datapath */
+	uint64_t bank[3][MEM_SIZE];
+	uint64_t dout_a[3], dout_b[3]; // RAM output registers per bank
+	int cur, oth, hst;       // bank of each role: current, other, host
+	int cur_r, hst_r;        // current/host bank of the last read
+	bool db;                 // BANK_REG: host ports use the host bank
+	bool ie, irq_pend, done_r; // IRQ_REG enable, pending flag, Done edge detect
+	uint16_t icount, jcount;
+	uint16_t jd, minidx;     // address of Mj, index of the minimum
+	uint64_t minv;           // running minimum
+	bool found;              // minimum is not M[i]
+	uint32_t w, lo, mi, mj, mk, mid, hi; // merge_counters
+	/* radix_counters */
+	int radix_bits, passes;
+	uint32_t rc;             // phase clock counter
+	int rpass;
+	bool rv1, rv2, rv3, rpv1; // count/scatter and prefix sum pipeline
+	uint32_t rd2, rd3, rb1;  // digits in the pipeline, bucket of the prefix sum
+	uint64_t re2;            // element in the write stage
+	uint32_t rc3, racc;      // last written counter, prefix sum
+	uint32_t rcnt[256], rdouta; // counter RAM and its port A output
+	bool rmap[256];          // counters written in the count phase
+	uint32_t rm, rg, rkk;    // ALG_SELECT: elements, first position, rank in them
+	uint32_t rsel_b, rsel_base, rsel_cnt, rwp; // bucket of the rank, kept elements
+	StreamHeapModel heap;
+	/* hist_unit */
+	uint16_t hist[256];      // bucket counters
+	int hist_b;              // bucket of the counting sort readback (top)
+	uint16_t hist_r;         // elements left in bucket hist_b
+	/* gen_unit */
+	bool gen_run, gen_byte;
+	int gen_pat;
+	uint16_t gen_lfsr, gen_i;
+	uint32_t gen_div;
+	/* check_unit */
+	uint16_t chk_cnt_in, chk_cnt_out;
+	uint32_t chk_sum_in, chk_sum_out, chk_xor_in, chk_xor_out;
+	uint32_t chk_last;       // last key read back
+	bool chk_have_last, chk_bad;
+	int alg;
+	/* controller */
+	ctrl_state state;
+	/* chu_sorting_core wrapper */
+	bool s, WrInit_r, Rd_r;
+	uint16_t n_reg, k_reg;
+	uint16_t ri;
+	/* pack_unit */
+	bool pk_pend, pk_phase, pk_rd_phase, pk_rd_valid;
+	uint16_t pk_pend_addr, pk_pend_d2, pk_pend_d3;
+	uint64_t rbuf[4];            // read-ahead buffer MEM[ri .. ri+3]
+	bool win_rd_r;               // memory window read on the last clock
+	/* element words */
+	int key_width;
+	bool index;
+	/* network_controller */
+	int net_lanes;
+	uint64_t net_remaining;  // clocks left until Done
+	/* Banked_datapath */
+	int sel_lanes;
+	bool banked;             // sel_lanes > 1 (and net_lanes = 0)
+	bool hb;                 // host bank present: HOST_BANK on Sorting_datapath
+	/* bookkeeping */
+	bool free_running;
+	uint64_t time;           // model clock
+	uint64_t start_time;     // clock at which s rose
+	uint64_t cycles, writes;
+
+	uint32_t clock(bool wr, bool rd, int addr, uint32_t wr_data, bool win = false);
+	uint64_t word(uint32_t key, uint16_t addr); // pack_unit DinA/DinB
+	uint32_t key_of(uint64_t w);
+	uint32_t index_of(uint64_t w);
+	uint64_t network_sort();
+	uint64_t banked_sort();
+	uint16_t i_last();         // icounter: last outer iteration (N-2 or K-1)
+	void hist_seek(int from);
+	void sync();
+	uint64_t run_to_done();
+};
+
+#endif  // _HOST_EMU
+
+#endif  // _SORT_CORE_MODEL_H_INCLUDED
@@ -35,6 +35,12 @@
  *
  * 3) SORTING
  * Pressing BTNC (when SW12=0) should initiate sorting.
+ * SW6...SW4 select the hardware algorithm: 0 selection sort, 1 merge sort (ping-pong BRAM banks),
+ * 2 streaming heap (sorted while the data is written, readback right after the last write),
+ * 3 counting sort of the 8-bit keys from the histogram built during the load (w = 8 only, merge sort for w = 16),
+ * 4 LSD radix sort (same cycle count for every input order).
+ * SW7=1 (zero copy, algorithms 0, 1 and 4): init builds hw_data[] directly in the core memory window
+ * (SortCore::buffer()) and the result is read in place, so the timed hardware sort has no copy phases.
  * Sorting is performed in hardware and software. Sorting in software should be performed on the array sw_data[ ] stored in the
  * Processor memory. Sorting in hardware should involve transferring input data from the array
  * hw_data[ ] to the Sorting core, performing sorting, and transferring results back to the array
@@ -56,6 +62,22 @@
  * The position of the switch SW15 should have the following meaning:
  * SW15=0 : number of clock cycles used for sorting in software
  * SW15=1 : number of clock cycles used for sorting in hardware.
+ * Pressing BTNC in the Cycle Count Mode dumps the profiler regions (count, min/avg/max/sum
+ * cycles and log2 histogram of the load, sort and readback phases of every run) and the MMIO
+ * accesses per slot of the last hardware sort (bus monitor) over the UART.
+ *
+ * 5) BENCHMARK SWEEP
+ * Pressing BTNC when SW12=1 (Display Mode) runs software_sort() and hardware_sort() for k = 4..13,
+ * five input patterns (LFSR random, descending, ascending, few unique, nearly sorted) and
+ * BENCH_REPS runs per point with the algorithm and zero-copy setting of SW7...SW4. One CSV line per
+ * k, pattern and sorter is sent over the UART with the min/median/max cycles of the load, sort and
+ * readback phases and of the total (software: sort phase only), plus the failed runs. The hardware
+ * phases come from the timer capture registers strobed by the core (first to last element
+ * transferred, sort start to Done), so they exclude the MMIO call overhead counted in the total.
+ * The host build runs it with "sort_host -b [reps]" and prints the CSV to stdout.
+ *
+ * UART output is buffered (LOG_BUF_SIZE bytes in RAM): uart.disp() queues the text and returns,
+ * the tx fifo empty interrupt sends it. The interrupt is masked while a sort is timed.
  *
  */
 #include "drv/chu_init.h"
@@ -63,15 +85,28 @@
 #include "drv/sseg_core.h"
 #include "drv/sorting_core.h"
 #include "drv/timer_core.h"
+#include "drv/profiler.h"
+#include "drv/bus_monitor.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <cmath>
 #include <inttypes.h>
 #include <unistd.h>
+#ifdef _HOST_EMU
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "host/host_emu.h"
+#include "host/host_models.h"
+#include "host/sort_core_model.h"
+#endif
 
 #define MAX_SIZE 8192 //2^13
 #define NIBBLE_MASK 0x0F
+#define BENCH_REPS 5 // runs per benchmark point (board)
+#define BENCH_MAX_REPS 32
+#define LOG_BUF_SIZE 4096 // buffered UART output
 
 // Button bit-mapping
 #define BTN_UP     (1 << 0)
@@ -89,6 +124,17 @@ enum SystemState{
 	STATE_CYCLE_COUNT  // Showing timing
 };
 
+// Input patterns of init and of the benchmark sweep
+enum DataPattern {
+	PAT_RANDOM,        // LFSR
+	PAT_DESCENDING,    // N-1-i
+	PAT_ASCENDING,     // i
+	PAT_FEW_UNIQUE,    // LFSR & 3
+	PAT_NEARLY_SORTED, // ascending with N/16 random swaps
+	PAT_COUNT
+};
+const char *pattern_names[PAT_COUNT] = {"random", "descending", "ascending", "few_unique", "nearly_sorted"};
+
 
 // Global variables
 // volatile to avoid compiler over-optimization
@@ -98,10 +144,16 @@ volatile uint16_t hw_data[MAX_SIZE];
 uint16_t N = 16; // Current number of elements to sort
 uint8_t k = 4; //log2(N)
 uint16_t w = 8; // Data width (8 or 16 bits)
+int hw_alg = SortCore::ALG_SELECTION; // Hardware algorithm (SW6..4)
 uint16_t current_address  = 0;
 uint64_t sw_cycles = 0;
 uint64_t hw_total_cycles = 0;
+uint64_t hw_load_cycles = 0; // phases of hardware_sort() from the timer capture registers
+uint64_t hw_sort_cycles = 0;
+uint64_t hw_read_cycles = 0;
 int mismatches = 0;
+bool hw_check = false; // order and checksum verified by the core (SortCore::verify())
+bool zero_copy = false; // SW7: hw_data[] lives in the core memory window
 SystemState current_state = STATE_IDLE;
 
 // Hardware Core Instances
@@ -109,8 +161,12 @@ SystemState current_state = STATE_IDLE;
 TimerCore timer(get_slot_addr(BRIDGE_BASE, S0_SYS_TIMER));
 SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
 DebounceCore btn(get_slot_addr(BRIDGE_BASE, S7_BTN));
-SortCore sort(get_slot_addr(BRIDGE_BASE, S4_USER));
+SortCore sort(get_slot_addr(BRIDGE_BASE, S4_USER), get_sprite_addr(BRIDGE_BASE, V4_USER4));
 GpiCore sw(get_slot_addr(BRIDGE_BASE, S3_SW));
+Profiler prof(&timer);
+BusMonitor bus(get_slot_addr(BRIDGE_BASE, S14_BUS_MON));
+BusMonitor::Snapshot hw_bus; // MMIO accesses per slot of the last hardware_sort()
+uint8_t log_buf[LOG_BUF_SIZE]; // UART ring buffer, drained by INTC_UART_TX_IRQ
 
 // Software LFSR Class
 class LFSR {
@@ -139,6 +195,54 @@ void update_config() {
 	if (k>13) k = 13;
     N = (uint16_t)(1 << k);
     w = (k < 9) ? 8 : 16; // if k is greater than 8 then width must be 16
+    hw_alg = (sw_val >> 4) & 0x07; // SW6..4 defines the hardware algorithm
+    if (hw_alg > SortCore::ALG_RADIX) hw_alg = SortCore::ALG_SELECTION;
+    if (hw_alg == SortCore::ALG_HIST && w > 8) hw_alg = SortCore::ALG_MERGE; // 8-bit keys only
+    zero_copy = (sw_val >> 7) & 1; // SW7: sort in place in the core memory
+    if (!sort.buffer() || hw_alg == SortCore::ALG_STREAM || hw_alg == SortCore::ALG_HIST)
+    	zero_copy = false; // no window, or the result is not in the memory
+}
+
+// Sets N, k and w for k (benchmark sweep; update_config() reads them from the switches)
+void set_size(int kk) {
+    k = kk;
+    N = (uint16_t)(1 << k);
+    w = (k < 9) ? 8 : 16;
+}
+
+// Element i of hw_data[] (in the core memory window in zero-copy mode)
+uint16_t hw_value(int i) {
+    return zero_copy ? (uint16_t) sort.buffer()[i] : hw_data[i];
+}
+
+// Fills sw_data[] and hw_data[] (the core memory window in zero-copy mode)
+// with the same N values of the given pattern
+void fill_arrays(int pattern) {
+    for (int i = 0; i < N; i++) {
+        uint16_t val = (pattern == PAT_RANDOM) ? software_lfsr.next() :
+        		(pattern == PAT_FEW_UNIQUE) ? (software_lfsr.next() & 0x3) :
+        		(pattern == PAT_DESCENDING) ? (N - 1 - i) : i;
+        if (w == 8) val &= 0xFF; // Mask for 8-bit mode
+        sw_data[i] = val;
+    }
+    if (pattern == PAT_NEARLY_SORTED) {
+    	for (int s = 0; s < N / 16; s++) {
+    		int a = software_lfsr.next() % N, b = software_lfsr.next() % N;
+    		uint16_t temp = sw_data[a];
+    		sw_data[a] = sw_data[b];
+    		sw_data[b] = temp;
+    	}
+    }
+
+    io_ptr_t buf = sort.buffer();
+    if (zero_copy) {
+    	sort.set_n(N);
+    	sort.init_write(); // new data set for the load checksum
+    }
+    for (int i = 0; i < N; i++) {
+        if (zero_copy) buf[i] = sw_data[i];
+        else hw_data[i] = sw_data[i];
+    }
 }
 
 void init_arrays(bool random) {
@@ -155,16 +259,21 @@ void init_arrays(bool random) {
         uart.disp("Note: This triggers maximum comparisons for Selection Sort.\r\n");
     }
 
-    for (int i = 0; i < N; i++) {
-        uint16_t val = random ? software_lfsr.next() : (N - 1 - i);
-        if (w == 8) val &= 0xFF; // Mask for 8-bit mode
-        sw_data[i] = hw_data[i] = val;
-    }
+    if (zero_copy)
+    	uart.disp("Zero copy: hw_data[] built in the sorting core memory\r\n");
+    fill_arrays(random ? PAT_RANDOM : PAT_DESCENDING);
     uart.disp("Memory Initialized. N="); uart.disp(N); uart.disp("\r\n");
 }
 
+// uart.disp() only queues; the tx interrupt sends (a full buffer waits for the uart)
+void log_init() {
+    uart.set_buffer(log_buf, LOG_BUF_SIZE, UartCore::OVF_BLOCK);
+    uart.enable_tx_irq(INTC_UART_TX_IRQ);
+}
+
 // Software Sorting (Selection Sort Algorithm)
 void software_sort() {
+    intc_disable(INTC_UART_TX_IRQ); // no log drain inside the timed section
     timer.clear();
     timer.go();
 
@@ -181,42 +290,622 @@ void software_sort() {
     }
     timer.pause();
     sw_cycles = timer.read_tick();
+    intc_enable(INTC_UART_TX_IRQ);
+    static int prof_sw = prof.region("sw sort");
+    prof.add(prof_sw, sw_cycles);
+}
+
+// Clocks between two capture strobes of the sorting core since timer.clear()
+uint64_t phase_cycles(int first, int last) {
+    uint64_t t0 = timer.read_capture(first), t1 = timer.read_capture(last);
+    return (t1 > t0) ? t1 - t0 : 0;
+}
+
+// Phase of hardware_sort() into a profiler region (0: no such phase)
+void profile_phase(int id, uint64_t cycles) {
+    if (cycles) prof.add(id, cycles);
 }
 
 // Hardware Sorting
 void hardware_sort() {
+    BusMonitor::Snapshot bus0, bus1;
+    intc_disable(INTC_UART_TX_IRQ); // no log drain inside the timed section
+    bus.snapshot(&bus0);
     timer.clear();
     timer.go();
 
     // Write to Core (Host -> FPGA)
+    sort.set_algorithm(hw_alg);
+    sort.set_width(w); // w=8: four values per bus word, w=16: two
     sort.set_n(N);
-    sort.init_write(); // rw=1, init=1, s=0 (Write Mode), Reset internal pointer ri=0
-    for (int i = 0; i < N; i++){
-    	sort.write(hw_data[i]);
-    }
+    if (!zero_copy) {
+    	sort.init_write(); // rw=1, init=1, s=0 (Write Mode), Reset internal pointer ri=0
+    	sort.write_block((const uint16_t *) hw_data, N);
+    } // zero copy: the data set is already in the core memory
 
-    // Start sorting
-    sort.sort(); // s=1
-    while(!sort.done()); // Wait for Done Signal
+    // Start sorting (the streaming heap and the histogram are ready after the last write)
+    if (!sort.sorted_on_load()) {
+    	sort.sort_async(); // s=1, Done raises INTC_SORT_IRQ
+    	sort.wait(); // no STATUS_REG polling over the bus
+    }
 
     // Readback (FPGA -> Host)
     sort.init_read(); // rw=0, init=1, s=0 (Read Mode), Resets internal pointer ri=0
-    //sort.read();
+    if (!zero_copy)
+    	sort.read_block((uint16_t *) hw_data, N); // zero copy: read in place by the caller
+
+    timer.pause();
+    hw_total_cycles = timer.read_tick();
+    // the core strobed the capture registers at the phase boundaries:
+    // first to last element transferred, s rising to Done (0: no such phase)
+    hw_load_cycles = phase_cycles(SortCore::CAP_LOAD_START, SortCore::CAP_LOAD_END);
+    hw_sort_cycles = phase_cycles(SortCore::CAP_SORT_START, SortCore::CAP_SORT_DONE);
+    hw_read_cycles = phase_cycles(SortCore::CAP_READ_START, SortCore::CAP_READ_END);
+    bus.snapshot(&bus1);
+    BusMonitor::delta(&bus0, &bus1, &hw_bus);
+    intc_enable(INTC_UART_TX_IRQ);
+    // profiler regions from the capture registers: no scope (MMIO reads) in the timed section
+    static int prof_load = prof.region("hw load");
+    static int prof_sort = prof.region("hw sort");
+    static int prof_read = prof.region("hw readback");
+    profile_phase(prof_load, hw_load_cycles);
+    profile_phase(prof_sort, hw_sort_cycles);
+    profile_phase(prof_read, hw_read_cycles);
+    if (!zero_copy)
+    	hw_check = sort.verify(); // O(1): the core checked the readback
+}
 
+// Runs software and hardware sorting on the current arrays,
+// checks mismatches and prints the verification report
+void run_sort_and_verify() {
+    uart.disp("Sorting...\r\n");
+    uart.disp("1. Running Software Selection Sort on MicroBlaze CPU...\r\n");
+    software_sort();
+
+    uart.disp((hw_alg == SortCore::ALG_MERGE) ?
+    	"2. Running Hardware-Accelerated Merge Sort on FPGA Core...\r\n" :
+    	(hw_alg == SortCore::ALG_STREAM) ?
+    	"2. Running Hardware-Accelerated Streaming Sort on FPGA Core...\r\n" :
+    	(hw_alg == SortCore::ALG_RADIX) ?
+    	"2. Running Hardware-Accelerated Radix Sort on FPGA Core...\r\n" :
+    	(hw_alg == SortCore::ALG_HIST) ?
+    	"2. Running Hardware-Accelerated Counting Sort on FPGA Core...\r\n" :
+    	"2. Running Hardware-Accelerated Sort on FPGA Core...\r\n");
+    hardware_sort();
+
+    // Check Mismatches
+    uart.disp("\r\n--- Verification Report ---\r\n");
+    mismatches = 0;
     for (int i = 0; i < N; i++) {
-        // Read twice as required for the specific MMIO wrapper
-        //hw_data[i] = sort.read();
-        hw_data[i] = sort.read();
+    	uint16_t hw = hw_value(i);
+    	if (sw_data[i] != hw){
+    		if (mismatches <= 10) {
+    			// Only print the first 10 mismatches to avoid spamming UART
+    			uart.disp("Mismatch at Index ["); uart.disp(i); uart.disp("]: ");
+    			uart.disp("Expected(SW)="); uart.disp(sw_data[i]);
+    			uart.disp("  Actual(HW)="); uart.disp(hw);
+    			uart.disp("\r\n");
+    			if (i == 0 && hw == 0) uart.disp(" <- (Check BRAM Latency)");
+    			uart.disp("\r\n");
+    		}
+    		mismatches++;
+    	}
+    	// Only print the first 10 mismatches to avoid spamming UART
 
     }
+    if (zero_copy)
+    	hw_check = sort.verify(); // the window reads above were the readback
+    uart.disp("HW Self-Check (order + checksum): "); uart.disp(hw_check ? "PASS\r\n" : "FAIL\r\n");
+    if (mismatches == 0) uart.disp("> SUCCESS: All values match!\r\n");
+    else {
+    	uart.disp("> FAIL: "); uart.disp(mismatches); uart.disp(" mismatches found.\r\n");
+    }
+    // Calculate Speedup: (SW - HW) / HW * 100
+    double speedup = (hw_total_cycles > 0) ?
+    	((double)sw_cycles - (double)hw_total_cycles) / (double)hw_total_cycles * 100.0 : 0.0;
 
-    timer.pause();
-    hw_total_cycles = timer.read_tick();
+    // Print Stats
+    uart.disp("Done.\r\n");
+    uart.disp("Mismatches: "); uart.disp(mismatches); uart.disp("\r\n");
+    uart.disp("SW Cycles: "); uart.disp_u64(sw_cycles); uart.disp("\r\n");
+    uart.disp(" (0x"); uart.disp((int)sw_cycles, 16); uart.disp(")\r\n");
+
+    uart.disp("HW Cycles: "); uart.disp_u64(hw_total_cycles); uart.disp("\r\n");
+    uart.disp(" (0x"); uart.disp((int)hw_total_cycles, 16); uart.disp(")\r\n");
+
+    uart.disp("HW is "); uart.disp(speedup, 2); uart.disp("% Faster\r\n");
+    uart.disp("---------------------------\r\n");
+}
+
+// Profiler regions and the bus traffic of the last hardware sort over the UART
+void dump_profile() {
+    uart.disp("\r\n--- Profile ---\r\n");
+    prof.dump(&uart);
+    uart.disp("MMIO accesses of the last hardware sort (alg "); uart.disp(hw_alg);
+    uart.disp(", N="); uart.disp(N); uart.disp("):\r\n");
+    bus.report(&uart, &hw_bus);
+}
+
+// min, median (lower middle for an even count) and max of v[0..n-1]; sorts v
+void bench_stats(uint64_t *v, int n, uint64_t *stats) {
+    for (int i = 1; i < n; i++) {
+    	uint64_t x = v[i];
+    	int j = i;
+    	for (; j > 0 && v[j - 1] > x; j--) v[j] = v[j - 1];
+    	v[j] = x;
+    }
+    stats[0] = v[0];
+    stats[1] = v[(n - 1) / 2];
+    stats[2] = v[n - 1];
+}
+
+// Prints one benchmark line: ",min,med,max" for each phase
+void bench_line(const char *sorter, int pattern, int reps, uint64_t cycles[][BENCH_MAX_REPS], int failed) {
+    uart.disp(k); uart.disp(","); uart.disp(N); uart.disp(","); uart.disp(w); uart.disp(",");
+    uart.disp(pattern_names[pattern]); uart.disp(","); uart.disp(sorter); uart.disp(",");
+    uart.disp(hw_alg); uart.disp(","); uart.disp(zero_copy ? 1 : 0); uart.disp(","); uart.disp(reps);
+    for (int ph = 0; ph < 4; ph++) {
+    	uint64_t st[3];
+    	bench_stats(cycles[ph], reps, st);
+    	for (int i = 0; i < 3; i++) {
+    		uart.disp(","); uart.disp_u64(st[i]);
+    	}
+    }
+    uart.disp(","); uart.disp(failed); uart.disp("\r\n");
+}
+
+// Benchmark sweep: k = 4..13, every pattern, reps runs of software_sort() and
+// hardware_sort() per point (fresh data each run, same LFSR sequence every sweep).
+// Algorithm and zero copy come from the switches; returns the failed runs.
+int run_benchmark(int reps) {
+    static uint64_t sw_c[4][BENCH_MAX_REPS], hw_c[4][BENCH_MAX_REPS]; // load, sort, readback, total
+    if (reps < 1) reps = 1;
+    if (reps > BENCH_MAX_REPS) reps = BENCH_MAX_REPS;
+    update_config();
+    int alg = (sw.read() >> 4) & 0x07; // SW6..4, before the w = 16 fallback of update_config()
+    if (alg > SortCore::ALG_RADIX) alg = SortCore::ALG_SELECTION;
+    if (alg == SortCore::ALG_STREAM || alg == SortCore::ALG_HIST) zero_copy = false;
+    software_lfsr = LFSR();
+    int failed_total = 0;
+
+    uart.disp("k,N,w,pattern,sorter,alg,zero_copy,reps,load_min,load_med,load_max,sort_min,sort_med,sort_max,"
+    		"read_min,read_med,read_max,total_min,total_med,total_max,failed\r\n");
+    for (int kk = 4; kk <= 13; kk++) {
+    	set_size(kk);
+    	hw_alg = (alg == SortCore::ALG_HIST && w > 8) ? SortCore::ALG_MERGE : alg; // 8-bit keys only
+    	for (int p = 0; p < PAT_COUNT; p++) {
+    		int failed = 0;
+    		for (int r = 0; r < reps; r++) {
+    			fill_arrays(p);
+    			software_sort();
+    			hardware_sort();
+    			mismatches = 0;
+    			for (int i = 0; i < N; i++)
+    				if (sw_data[i] != hw_value(i)) mismatches++;
+    			if (zero_copy) hw_check = sort.verify();
+    			if (mismatches || !hw_check) failed++;
+    			sw_c[0][r] = 0;
+    			sw_c[1][r] = sw_cycles;
+    			sw_c[2][r] = 0;
+    			sw_c[3][r] = sw_cycles;
+    			hw_c[0][r] = hw_load_cycles;
+    			hw_c[1][r] = hw_sort_cycles;
+    			hw_c[2][r] = hw_read_cycles;
+    			hw_c[3][r] = hw_total_cycles;
+    		}
+    		bench_line("sw", p, reps, sw_c, 0);
+    		bench_line("hw", p, reps, hw_c, failed);
+    		failed_total += failed;
+    	}
+    }
+    update_config(); // back to the size on the switches
+    return failed_total;
 }
 
+#ifdef _HOST_EMU
+// Prints the core latency predicted by the cycle-accurate model
+// for N = 2^4 ... 2^13 and each data pattern (no board, no MMIO timing)
+void print_model_table() {
+    static uint16_t data[MAX_SIZE];
+    const char *names[3] = {"random", "descending", "ascending"};
+
+    const int lanes[3] = {4, 8, 16};
+    const int sel_lanes[3] = {2, 4, 8};
+
+    uart.disp("k,N,pattern,sort_cycles,swaps,merge_cycles,net4_cycles,net8_cycles,net16_cycles,"
+    		"sel2_cycles,sel4_cycles,sel8_cycles,radix8_cycles,radix4_cycles\r\n");
+    for (int kk = 4; kk <= 13; kk++) {
+        int n = 1 << kk;
+        for (int p = 0; p < 3; p++) {
+            LFSR lfsr;
+            for (int i = 0; i < n; i++) {
+                data[i] = (p == 0) ? lfsr.next() : (p == 1) ? (n - 1 - i) : i;
+                if (kk < 9) data[i] &= 0xFF; // w = 8
+            }
+            uint64_t swaps;
+            uint64_t cycles = SortCoreModel::predict(data, n, &swaps);
+            uart.disp(kk); uart.disp(","); uart.disp(n); uart.disp(",");
+            uart.disp(names[p]); uart.disp(",");
+            uart.disp_u64(cycles); uart.disp(","); uart.disp_u64(swaps); uart.disp(",");
+            uart.disp_u64(SortCoreModel::predict(data, n, 0, 0, SortCore::ALG_MERGE));
+            for (int l = 0; l < 3; l++) {
+                uart.disp(",");
+                uart.disp_u64(SortCoreModel::predict(data, n, 0, lanes[l]));
+            }
+            for (int l = 0; l < 3; l++) {
+                uart.disp(",");
+                uart.disp_u64(SortCoreModel::predict(data, n, 0, 0, SortCore::ALG_SELECTION, sel_lanes[l]));
+            }
+            for (int b = 8; b >= 4; b -= 4) {
+                uart.disp(",");
+                uart.disp_u64(SortCoreModel::predict(data, n, 0, 0, SortCore::ALG_RADIX, 1, b));
+            }
+            uart.disp("\r\n");
+        }
+    }
+}
+
+// Driver self-test (sort_host -t): the SortCore calls that the demo does not
+// make, checked against std::sort on LFSR data. One line per check. The
+// cycle counts leave out the host CPU time (bus, stalls and core model only),
+// so they repeat from run to run.
+int st_failed = 0;
+
+void st_report(const char *name, bool ok) {
+    uart.disp(name); uart.disp(ok ? ": PASS\r\n" : ": FAIL\r\n");
+    if (!ok) st_failed++;
+}
+
+// n LFSR values of w bits
+std::vector<uint16_t> st_data(int n, int w, uint16_t seed = 0xACE1) {
+    LFSR lfsr(seed);
+    std::vector<uint16_t> v(n);
+    for (int i = 0; i < n; i++) v[i] = lfsr.next() & ((1 << w) - 1);
+    return v;
+}
+
+// sort_external() for 13 runs (one merge pass) and 66 runs (two passes)
+void st_external() {
+    const uint32_t sizes[2] = {100000, 66 * SortCore::RUN_SIZE - 5};
+    for (int t = 0; t < 2; t++) {
+        uint32_t n = sizes[t];
+        std::vector<uint16_t> data = st_data(n, 16, 0x1234 + t), tmp(n), ref = data;
+        std::sort(ref.begin(), ref.end());
+        sort.set_algorithm(SortCore::ALG_MERGE);
+        timer.clear();
+        timer.go();
+        sort.sort_external(data.data(), n, tmp.data());
+        timer.pause();
+        uart.disp("sort_external n="); uart.disp((int)n); uart.disp(", cycles ");
+        uart.disp_u64(timer.read_tick());
+        st_report("", data == ref);
+    }
+}
+
+// ALG_STREAM: sorted during the load with the stream heap, by sort() on a
+// network core (no heap, STATUS SH bit 0)
+void st_stream() {
+    const int n = 1000;
+    std::vector<uint16_t> data = st_data(n, 16, 0x5A5A), out(n), ref = data;
+    std::sort(ref.begin(), ref.end());
+    sort.set_algorithm(SortCore::ALG_STREAM);
+    sort.set_width(16);
+    sort.set_n(n);
+    sort.init_write();
+    sort.write_block(data.data(), n);
+    bool heap = sort.sorted_on_load();
+    if (!heap) {
+        sort.sort_async();
+        sort.wait();
+    }
+    sort.init_read();
+    sort.read_block(out.data(), n);
+    uart.disp(heap ? "stream (heap)" : "stream (no heap, sort_async())");
+    st_report("", out == ref);
+}
+
+// partial_sort(): the k smallest against the first k of std::sort, every
+// engine (ALG_SELECT runs the selection sort), k = 1, 37, n and n < 2
+void st_partial() {
+    const int n = 300, ks[3] = {1, 37, n};
+    const int algs[5] = {SortCore::ALG_SELECTION, SortCore::ALG_MERGE, SortCore::ALG_STREAM,
+    		SortCore::ALG_RADIX, SortCore::ALG_SELECT};
+    std::vector<uint16_t> data = st_data(n, 16, 0x2468), out(n), ref = data;
+    std::sort(ref.begin(), ref.end());
+    sort.set_width(16);
+    for (int a = 0; a < 5; a++) {
+        sort.set_algorithm(algs[a]);
+        bool ok = true;
+        for (int t = 0; t < 3; t++) {
+            std::fill(out.begin(), out.end(), 0xFFFF);
+            ok = ok && sort.partial_sort(data.data(), n, ks[t], out.data()) &&
+            		std::equal(out.begin(), out.begin() + ks[t], ref.begin());
+        }
+        uart.disp("partial_sort alg "); uart.disp(algs[a]);
+        st_report("", ok);
+    }
+    uint16_t one = 0x1234, r = 0;
+    st_report("partial_sort n=1", sort.partial_sort(&one, 1, 5, &r) && r == one);
+}
+
+// select(): one rank (ALG_SELECT) and several ranks (ALG_RADIX) against
+// std::nth_element, a rank out of range is refused
+void st_select() {
+    const int n = 1000, m = 5;
+    const uint16_t ranks[m] = {n / 2, 0, 1, 733, n - 1};
+    std::vector<uint16_t> data = st_data(n, 16, 0x1357);
+    uint32_t out[m];
+    sort.set_algorithm(SortCore::ALG_MERGE);
+    sort.set_width(16);
+    for (int cnt = 1; cnt <= m; cnt += m - 1) {
+        sort.set_n(n);
+        sort.init_write();
+        sort.write_block(data.data(), n);
+        bool ok = sort.select(ranks, cnt, out);
+        for (int i = 0; ok && i < cnt; i++) {
+            std::vector<uint16_t> ref = data;
+            std::nth_element(ref.begin(), ref.begin() + ranks[i], ref.end());
+            ok = out[i] == ref[ranks[i]];
+        }
+        uart.disp("select "); uart.disp(cnt); uart.disp(cnt == 1 ? " rank" : " ranks");
+        st_report("", ok);
+    }
+    const uint16_t bad = n;
+    st_report("select rank n refused", !sort.select(&bad, 1, out));
+}
+
+// sort_index(): permutation and keys against std::stable_sort (equal keys in
+// load order) on every engine; a core without INDEX must refuse the call
+void st_index() {
+    const int n = 500;
+    const int algs[5] = {SortCore::ALG_SELECTION, SortCore::ALG_MERGE, SortCore::ALG_STREAM,
+    		SortCore::ALG_RADIX, SortCore::ALG_SELECT};
+    int kw = sort.key_width();
+    uint32_t kmask = kw >= 32 ? 0xFFFFFFFF : (1u << kw) - 1;
+    std::vector<uint16_t> a = st_data(n, 16, 0x0F0F), b = st_data(n, 16, 0xF0F0), perm(n), ref(n);
+    std::vector<uint32_t> keys(n), out(n);
+    for (int i = 0; i < n; i++) // every other key from 0..7, so there are ties
+        keys[i] = (i & 1) ? a[i] & 7 : ((uint32_t)a[i] << 16 | b[i]) & kmask;
+    for (int i = 0; i < n; i++) ref[i] = i;
+    std::stable_sort(ref.begin(), ref.end(), [&](uint16_t x, uint16_t y) { return keys[x] < keys[y]; });
+    if (!HOST_INDEX) { // the model of the core is built without INDEX
+        sort.set_algorithm(SortCore::ALG_MERGE);
+        st_report("sort_index without INDEX refused", !sort.sort_index(keys.data(), n, perm.data()));
+        return;
+    }
+    for (int t = 0; t < 5; t++) {
+        sort.set_algorithm(algs[t]);
+        bool ok = sort.sort_index(keys.data(), n, perm.data(), out.data());
+        for (int i = 0; ok && i < n; i++) ok = perm[i] == ref[i] && out[i] == keys[ref[i]];
+        uart.disp("sort_index alg "); uart.disp(algs[t]); uart.disp(", key width "); uart.disp(kw);
+        st_report("", ok);
+    }
+}
+
+// generate(): every pattern at 16 and 8 bits against the same pattern built
+// in software (LFSR class), read back as loaded and after a merge sort
+void st_generate() {
+    const int n = 1000;
+    const uint16_t seed = 0xBEEF;
+    std::vector<uint16_t> out(n);
+    sort.set_algorithm(SortCore::ALG_MERGE);
+    for (int w = 16; w >= 8; w -= 8) {
+        sort.set_width(w);
+        for (int pat = SortCore::GEN_LFSR; pat <= SortCore::GEN_FEW; pat++) {
+            LFSR lfsr(seed);
+            std::vector<uint16_t> ref(n);
+            for (int i = 0; i < n; i++) {
+                uint16_t v = lfsr.next();
+                ref[i] = pat == SortCore::GEN_DESC ? n - 1 - i : pat == SortCore::GEN_ASC ? i :
+                		pat == SortCore::GEN_FEW ? v & 3 : v;
+                if (w == 8) ref[i] &= 0xFF;
+            }
+            sort.generate(n, pat, w, seed);
+            sort.init_read();
+            sort.read_block(out.data(), n);
+            bool ok = out == ref;
+            std::sort(ref.begin(), ref.end());
+            sort.generate(n, pat, w, seed);
+            sort.sort_async();
+            sort.wait();
+            sort.init_read();
+            sort.read_block(out.data(), n);
+            ok = ok && out == ref && sort.verify();
+            uart.disp("generate pattern "); uart.disp(pat); uart.disp(", w "); uart.disp(w);
+            st_report("", ok);
+        }
+    }
+}
+
+// read_at()/write_at(): random reads of the loaded and the sorted data,
+// overwrites seen by read_at() and by a block readback
+void st_random_access() {
+    const int n = 500, pos[6] = {0, 1, 77, 250, 498, n - 1};
+    std::vector<uint16_t> data = st_data(n, 16, 0x0BAD), out(n), ref = data;
+    uint32_t kmask = sort.key_width() >= 32 ? 0xFFFFFFFF : (1u << sort.key_width()) - 1;
+    sort.set_algorithm(SortCore::ALG_MERGE);
+    sort.set_width(16);
+    sort.set_n(n);
+    sort.init_write();
+    sort.write_block(data.data(), n);
+    bool ok = true;
+    for (int t = 5; t >= 0; t--) ok = ok && sort.read_at(pos[t]) == data[pos[t]];
+    for (int t = 0; t < 6; t++) {
+        ref[pos[t]] = 0xFFFF - t;
+        sort.write_at(pos[t], ref[pos[t]]);
+    }
+    for (int t = 0; t < 6; t++) ok = ok && sort.read_at(pos[t]) == ref[pos[t]];
+    sort.init_read();
+    sort.read_block(out.data(), n);
+    ok = ok && out == ref;
+    sort.write_at(3, 0xABCDE12u); // the core keeps the low key_width() bits
+    ok = ok && sort.read_at(3) == (0xABCDE12u & kmask);
+    st_report("read_at/write_at loaded", ok);
+
+    sort.set_n(n);
+    sort.init_write();
+    sort.write_block(data.data(), n);
+    std::sort(data.begin(), data.end());
+    sort.sort_async();
+    sort.wait();
+    sort.idle();
+    ok = true;
+    for (int t = 0; t < 6; t++) ok = ok && sort.read_at(pos[t]) == data[pos[t]];
+    st_report("read_at sorted", ok);
+}
+
+// verify(): true after a full sorted readback (16 and 8-bit transfers), false
+// for an unsorted, short or overwritten readback
+void st_verify() {
+    const int n = 600;
+    static const char *const name[5] = {"verify sorted", "verify sorted, w 8", "verify unsorted",
+    		"verify short readback", "verify after write_at"};
+    std::vector<uint16_t> data = st_data(n, 16, 0x7777), out(n);
+    sort.set_algorithm(SortCore::ALG_MERGE);
+    sort.set_n(n);
+    for (int t = 0; t < 5; t++) {
+        sort.set_width(t == 1 ? 8 : 16);
+        sort.init_write();
+        sort.write_block(data.data(), n);
+        if (t == 4) sort.write_at(10, data[10] + 1); // overwrite: loaded sum changes
+        if (t != 2) { // t = 2: read back unsorted
+            sort.sort_async();
+            sort.wait();
+        }
+        sort.init_read();
+        sort.read_block(out.data(), t == 3 ? n - 1 : n); // t = 3: one element short
+        st_report(name[t], sort.verify() == (t < 2));
+    }
+}
+
+// submit()/collect() pipeline: 8 batches of N=8192 with merge sort, one at a
+// time and double buffered (host bank builds only), every result checked
+void st_batches() {
+    const int B = 8, n = SortCore::RUN_SIZE;
+    std::vector<uint16_t> in[B], out[B];
+    for (int b = 0; b < B; b++) {
+        in[b] = st_data(n, 16, 0x0101 * (b + 1));
+        out[b].resize(n);
+    }
+    sort.set_algorithm(SortCore::ALG_MERGE);
+    for (int db = 0; db < 2; db++) {
+        if (sort.set_double_buffer(db) != (bool) db) {
+            uart.disp("batches double buffered: no host bank, skipped\r\n");
+            break;
+        }
+        bool ok = true;
+        int next = 0, got = 0;
+        timer.clear();
+        timer.go();
+        while (got < B) {
+            // submit() is false while a result waits for collect()
+            if (next < B && sort.submit(in[next].data(), n)) next++;
+            else if (sort.collect(out[got].data()) == n) got++;
+            else {
+                ok = false;
+                break;
+            }
+        }
+        ok = ok && sort.collect(out[0].data()) == 0;
+        timer.pause();
+        for (int b = 0; b < got; b++) {
+            std::vector<uint16_t> ref = in[b];
+            std::sort(ref.begin(), ref.end());
+            ok = ok && out[b] == ref;
+        }
+        uart.disp(db ? "batches double buffered" : "batches one at a time");
+        uart.disp(", cycles "); uart.disp_u64(timer.read_tick());
+        st_report("", ok);
+    }
+    sort.set_double_buffer(false);
+}
+
+int run_self_test() {
+    st_failed = 0;
+    host_set_wall_clock(false);
+    st_batches();
+    st_external();
+    st_stream();
+    st_partial();
+    st_select();
+    st_index();
+    st_generate();
+    st_random_access();
+    st_verify();
+    sort.set_algorithm(SortCore::ALG_SELECTION);
+    host_set_wall_clock(true);
+    uart.disp("self-test: "); uart.disp(st_failed); uart.disp(" failed\r\n");
+    return st_failed;
+}
+
+// HOST MAIN (Linux build, see host/host_io.h)
+// usage: sort_host [-z] [-a alg] [k_first [k_last]]; runs both data patterns for each k
+//        (alg = SortCore::ALG_*, set through SW6..4; -z: zero copy, SW7)
+//        sort_host -m; prints the model latency table
+//        sort_host -t; driver self-test against std::sort
+//        sort_host [-z] [-a alg] -b [reps]; benchmark sweep CSV (BENCH_REPS runs per point)
+//        -p before the other options: dump the profiler regions at the end
+int main(int argc, char *argv[]) {
+    init_fix();
+    log_init();
+    if (argc > 1 && strcmp(argv[1], "-m") == 0) {
+        print_model_table();
+        uart.flush();
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "-t") == 0) {
+        int failed = run_self_test();
+        uart.flush();
+        return (failed == 0) ? 0 : 1;
+    }
+    HostGpi *sw_model = static_cast<HostGpi *>(host_device(S3_SW));
+    uint32_t sw_alg = 0;
+    bool profile = false;
+    if (argc > 1 && strcmp(argv[1], "-p") == 0) {
+        profile = true;
+        argc--;
+        argv++;
+    }
+    if (argc > 1 && strcmp(argv[1], "-z") == 0) {
+        sw_alg = 0x80;
+        argc--;
+        argv++;
+    }
+    if (argc > 2 && strcmp(argv[1], "-a") == 0) {
+        sw_alg |= (atoi(argv[2]) & 0x07) << 4;
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+        sw_model->set(sw_alg);
+        int failed = run_benchmark((argc > 2) ? atoi(argv[2]) : BENCH_REPS);
+        if (profile) dump_profile();
+        uart.flush();
+        return (failed == 0) ? 0 : 1;
+    }
+    int k_first = (argc > 1) ? atoi(argv[1]) : 4;
+    int k_last = (argc > 2) ? atoi(argv[2]) : k_first;
+    int failed = 0;
+
+    uart.disp("\r\n--- HOST EMULATION, SYSTEM READY ---\r\n");
+    for (int kk = k_first; kk <= k_last; kk++) {
+        sw_model->set(sw_alg | kk); // SW6..4 = algorithm, SW3..0 = k
+        init_arrays(true);
+        run_sort_and_verify();
+        failed += mismatches + !hw_check;
+        init_arrays(false);
+        run_sort_and_verify();
+        failed += mismatches + !hw_check;
+    }
+    if (profile) dump_profile();
+    uart.flush();
+    return (failed == 0) ? 0 : 1;
+}
+#else
 // MAIN LOOP
 int main() {
     init_fix();
+    log_init();
     timer.sleep(500); // Wait 100ms for UART to stabilize
     uart.disp("\r\n--- Project by Kainoa L. Asse ---\r\n");
     uart.disp("\r\n--- HELLO WORLD, SYSTEM READY ---\r\n");
@@ -226,6 +915,8 @@ int main() {
     uint32_t db_old = btn.read_db();
 
     while (1) {
+        uart.poll(); // log drain without the tx interrupt (no-op with it)
+
         // Read inputs
     	uint32_t sw_val = sw.read();
     	// Extract specific switch bits for easier use in logic
@@ -288,6 +979,14 @@ int main() {
                 if ((pressed & BTN_CENTER) && sw12 == 0) {
                     current_state = STATE_SORTING;
                 }
+                // Benchmark sweep: Center button + SW12 == 1 (CSV over UART)
+                if ((pressed & BTN_CENTER) && sw12 == 1) {
+                	uint8_t dash[4] = {0xBF, 0xBF, 0xBF, 0xBF};
+                	sseg.write_8ptn(dash);
+                	uart.disp("\r\n--- Benchmark Sweep ---\r\n");
+                	mismatches = run_benchmark(BENCH_REPS); // failed runs, shown in the Mismatch display
+                	current_state = STATE_MISMATCH;
+                }
             break;
 
             case STATE_SORTING:
@@ -296,52 +995,7 @@ int main() {
             	uint8_t dash[4] = {0xBF, 0xBF, 0xBF, 0xBF};
             	sseg.write_8ptn(dash);
 
-
-                uart.disp("Sorting...\r\n");
-                uart.disp("1. Running Software Selection Sort on MicroBlaze CPU...\r\n");
-                software_sort();
-
-                uart.disp("2. Running Hardware-Accelerated Sort on FPGA Core...\r\n");
-                hardware_sort();
-
-                // Check Mismatches
-                uart.disp("\r\n--- Verification Report ---\r\n");
-                mismatches = 0;
-                for (int i = 0; i < N; i++) {
-                	if (sw_data[i] != hw_data[i]){
-                		if (mismatches <= 10) {
-                			// Only print the first 10 mismatches to avoid spamming UART
-                			uart.disp("Mismatch at Index ["); uart.disp(i); uart.disp("]: ");
-                			uart.disp("Expected(SW)="); uart.disp(sw_data[i]);
-                			uart.disp("  Actual(HW)="); uart.disp(hw_data[i]);
-                			uart.disp("\r\n");
-                			if (i == 0 && hw_data[i] == 0) uart.disp(" <- (Check BRAM Latency)");
-                			uart.disp("\r\n");
-                		}
-                		mismatches++;
-                	}
-                	// Only print the first 10 mismatches to avoid spamming UART
-
-                }
-                if (mismatches == 0) uart.disp("> SUCCESS: All values match!\r\n");
-                else {
-                	uart.disp("> FAIL: "); uart.disp(mismatches); uart.disp(" mismatches found.\r\n");
-                }
-                // Calculate Speedup: (SW - HW) / HW * 100
-                double speedup = (hw_total_cycles > 0) ?
-                	((double)sw_cycles - (double)hw_total_cycles) / (double)hw_total_cycles * 100.0 : 0.0;
-
-                // Print Stats
-                uart.disp("Done.\r\n");
-                uart.disp("Mismatches: "); uart.disp(mismatches); uart.disp("\r\n");
-                uart.disp("SW Cycles: "); uart.disp((int)sw_cycles); uart.disp("\r\n");
-                uart.disp(" (0x"); uart.disp((int)sw_cycles, 16); uart.disp(")\r\n");
-
-                uart.disp("HW Cycles: "); uart.disp((int)hw_total_cycles); uart.disp("\r\n");
-                uart.disp(" (0x"); uart.disp((int)hw_total_cycles, 16); uart.disp(")\r\n");
-
-                uart.disp("HW is "); uart.disp(speedup, 2); uart.disp("% Faster\r\n");
-                uart.disp("---------------------------\r\n");
+                run_sort_and_verify();
                 current_state = STATE_MISMATCH;
             }
 
@@ -366,6 +1020,10 @@ int main() {
             		current_state = STATE_DISPLAY;
             	    uart.disp("Returning to DISPLAY\r\n");
             	}
+            	// BTNC: profiler dump
+            	if (pressed & BTN_CENTER) {
+            		dump_profile();
+            	}
             break;
         }
 
@@ -389,7 +1047,7 @@ int main() {
                 ptn[1] = sseg.h2s(w / 10); ptn[0] = sseg.h2s(w % 10);
             } else {
             	// Browsing: [Addr][Value]
-            	uint16_t val = sw15 ? hw_data[current_address] : sw_data[current_address];
+            	uint16_t val = sw15 ? hw_value(current_address) : sw_data[current_address];
                 ptn[3] = sseg.h2s((current_address >> 4) & 0xF);
                 ptn[2] = sseg.h2s(current_address & 0xF);
                 ptn[1] = sseg.h2s((val >> 4) & 0xF);
@@ -401,5 +1059,4 @@ int main() {
         }
     }
 }
-
-
+#endif // _HOST_EMU